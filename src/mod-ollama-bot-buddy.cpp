@@ -1,6 +1,7 @@
 #include "mod-ollama-bot-buddy_config.h"
 #include "mod-ollama-bot-buddy_loop.h"
 #include "mod-ollama-bot-buddy_handler.h"
+#include "mod-ollama-bot-buddy_commands.h"
 
 #include "Log.h"
 
@@ -10,4 +11,5 @@ void Addmod_ollama_bot_buddyScripts()
     LOG_INFO("server.loading", "Registering mod-ollama-bot-buddy scripts.");
     new OllamaBotControlLoop();
     new BotBuddyChatHandler();
+    new BotBuddyCommandScript();
 }
@@ -1,6 +1,8 @@
 #include "mod-ollama-bot-buddy_api.h"
 #include "mod-ollama-bot-buddy_config.h"
 #include "mod-ollama-bot-buddy_loop.h"
+#include "mod-ollama-bot-buddy_stats.h"
+#include "mod-ollama-bot-buddy_targets.h"
 #include "Playerbots.h"
 #include "PlayerbotAI.h"
 #include "ObjectAccessor.h"
@@ -12,7 +14,11 @@
 #include "GridNotifiersImpl.h"
 #include "Cell.h"
 #include "Map.h"
+#include <limits>
 #include <sstream>
+#include <string_view>
+#include <type_traits>
+#include <utility>
 
 namespace BotBuddyAI
 {
@@ -120,13 +126,10 @@ namespace BotBuddyAI
     {
         if (!bot) return false;
 
-        Map* map = bot->GetMap();
-        if (!map) return false;
-
-        for (const auto& pair : map->GetCreatureBySpawnIdStore())
+        // Only corpses from the bot's last snapshot are candidates
+        for (Creature* creature : GetIndexedBotCreatures(bot))
         {
-            Creature* creature = pair.second;
-            if (!creature || !creature->isDead()) continue;
+            if (!creature->isDead() || !creature->HasFlag(UNIT_DYNAMIC_FLAGS, UNIT_DYNFLAG_LOOTABLE)) continue;
 
             if (!bot->IsWithinDistInMap(creature, INTERACTION_DISTANCE)) continue;
 
@@ -141,403 +144,208 @@ namespace BotBuddyAI
 
 } // namespace BotBuddyAI
 
-bool HandleBotControlCommand(Player* bot, const BotControlCommand& command)
+namespace
 {
-    if (g_EnableOllamaBotBuddyDebug && bot)
+    // Resolved at compile time by std::visit, one overload per command
+    bool ExecuteBotCommand(Player* bot, StopCommand const& /*command*/)
     {
-        LOG_INFO("server.loading", "[OllamaBotBuddy] HandleBotControlCommand for '{}', type {}", bot->GetName(), int(command.type));
-        LOG_INFO("server.loading", "[OllamaBotBuddy] ================================================================================================");
+        return BotBuddyAI::StopMoving(bot);
     }
-    if (!bot) return false;
-    switch (command.type)
-    {
-        case BotControlCommandType::MoveTo:
-            if (command.args.size() >= 3)
-            {
-                float x = std::stof(command.args[0]);
-                float y = std::stof(command.args[1]);
-                float z = std::stof(command.args[2]);
-                return BotBuddyAI::MoveTo(bot, x, y, z);
-            }
-            break;
-        case BotControlCommandType::Attack:
-            if (!command.args.empty())
-            {
-                uint32 lowGuid = 0;
-                try {
-                    lowGuid = std::stoul(command.args[0]);
-                } catch (const std::invalid_argument& e) {
-                    LOG_ERROR("server.loading", "[OllamaBotBuddy] Invalid argument for lowGuid '{}'", command.args[0]);
-                    return false;
-                } catch (const std::out_of_range& e) {
-                    LOG_ERROR("server.loading", "[OllamaBotBuddy] Out of range value for lowGuid '{}'", command.args[0]);
-                    return false;
-                }
-
-                // Try to find the Creature by LowGuid first
-                Creature* creatureTarget = nullptr;
-                for (auto const& pair : bot->GetMap()->GetCreatureBySpawnIdStore())
-                {
-                    Creature* c = pair.second;
-                    if (!c) continue;
-                    if (c->GetGUID().GetCounter() == lowGuid)
-                    {
-                        creatureTarget = c;
-                        break;
-                    }
-                }
-
-                if (creatureTarget)
-                {
-                    // Use the actual GUID from the creature, never reconstruct!
-                    return BotBuddyAI::Attack(bot, creatureTarget->GetGUID());
-                }
-
-                // If not found, try Player
-                ObjectGuid guid = ObjectGuid::Create<HighGuid::Player>(lowGuid);
-                Player* playerTarget = ObjectAccessor::FindConnectedPlayer(guid);
-                if (playerTarget)
-                {
-                    return BotBuddyAI::Attack(bot, playerTarget->GetGUID());
-                }
-
-                LOG_INFO("server.loading", "[OllamaBotBuddy] Could not find target with lowGuid {}", lowGuid);
-                return false;
-            }
-            break;
-        case BotControlCommandType::Interact:
-            if (!command.args.empty())
-            {
-                uint32 lowGuid = 0;
-                try {
-                    lowGuid = std::stoul(command.args[0]);
-                } catch (const std::invalid_argument& e) {
-                    LOG_ERROR("server.loading", "[OllamaBotBuddy] Invalid argument for lowGuid '{}'", command.args[0]);
-                    return false;
-                } catch (const std::out_of_range& e) {
-                    LOG_ERROR("server.loading", "[OllamaBotBuddy] Out of range value for lowGuid '{}'", command.args[0]);
-                    return false;
-                }
-                Creature* creatureTarget = nullptr;
-                GameObject* goTarget = nullptr;
-
-                // Find creature by LowGuid
-                for (auto const& pair : bot->GetMap()->GetCreatureBySpawnIdStore())
-                {
-                    Creature* c = pair.second;
-                    if (!c) continue;
-                    if (c->GetGUID().GetCounter() == lowGuid)
-                    {
-                        creatureTarget = c;
-                        break;
-                    }
-                }
-
-                if (creatureTarget)
-                {
-                    return BotBuddyAI::Interact(bot, creatureTarget->GetGUID());
-                }
-
-                // Find gameobject by LowGuid
-                for (auto const& pair : bot->GetMap()->GetGameObjectBySpawnIdStore())
-                {
-                    GameObject* go = pair.second;
-                    if (!go) continue;
-                    if (go->GetGUID().GetCounter() == lowGuid)
-                    {
-                        goTarget = go;
-                        break;
-                    }
-                }
-
-                if (goTarget)
-                {
-                    return BotBuddyAI::Interact(bot, goTarget->GetGUID());
-                }
-
-                LOG_INFO("server.loading", "[OllamaBotBuddy] Could not find interact target with lowGuid {}", lowGuid);
-                return false;
-            }
-            break;
-        case BotControlCommandType::CastSpell:
-            if (!command.args.empty())
-            {
-                uint32 spellId = 0;
-                try {
-                    spellId = std::stoi(command.args[0]);
-                } catch (const std::invalid_argument& e) {
-                    LOG_ERROR("server.loading", "[OllamaBotBuddy] Invalid argument for spellId '{}'", command.args[0]);
-                    return false;
-                } catch (const std::out_of_range& e) {
-                    LOG_ERROR("server.loading", "[OllamaBotBuddy] Out of range value for spellId '{}'", command.args[0]);
-                    return false;
-                }
-                Unit* target = nullptr;
-                if (command.args.size() > 1)
-                {
-                    uint32 lowGuid = 0;
-        try {
-            lowGuid = std::stoul(command.args[1]);
-        } catch (const std::invalid_argument& e) {
-            LOG_ERROR("server.loading", "[OllamaBotBuddy] Invalid argument for lowGuid '{}'", command.args[1]);
-            return false;
-        } catch (const std::out_of_range& e) {
-            LOG_ERROR("server.loading", "[OllamaBotBuddy] Out of range value for lowGuid '{}'", command.args[1]);
-            return false;
-        }
-                    // Try to find creature by lowGuid
-                    for (auto const& pair : bot->GetMap()->GetCreatureBySpawnIdStore())
-                    {
-                        Creature* c = pair.second;
-                        if (c && c->GetGUID().GetCounter() == lowGuid)
-                        {
-                            target = c;
-                            break;
-                        }
-                    }
-                    // Try to find player by lowGuid if not found
-                    if (!target)
-                    {
-                        ObjectGuid guid = ObjectGuid::Create<HighGuid::Player>(lowGuid);
-                        Player* playerTarget = ObjectAccessor::FindConnectedPlayer(guid);
-                        if (playerTarget) target = playerTarget;
-                    }
-                }
-                else
-                {
-                    target = bot; // Use bot itself as the target if no guid provided
-                }
-                return BotBuddyAI::CastSpell(bot, spellId, target);
-            }
-            break;
-        case BotControlCommandType::Say:
-            if (!command.args.empty())
-            {
-                return BotBuddyAI::Say(bot, command.args[0]);
-            }
-            break;
-        case BotControlCommandType::Follow:
-            return BotBuddyAI::FollowMaster(bot);
-        case BotControlCommandType::Stop:
-            return BotBuddyAI::StopMoving(bot);
-        case BotControlCommandType::AcceptQuest:
-            if (!command.args.empty())
-            {
-                uint32 questId = std::stoi(command.args[0]);
-                return BotBuddyAI::AcceptQuest(bot, questId);
-            }
-            break;
-        case BotControlCommandType::TurnInQuest:
-            if (!command.args.empty())
-            {
-                uint32 questId = std::stoi(command.args[0]);
-                return BotBuddyAI::TurnInQuest(bot, questId);
-            }
-            break;
-        case BotControlCommandType::Loot:
-            return BotBuddyAI::LootNearby(bot);
-        default:
-            break;
-    }
-    return false;
-}
 
-
-bool ParseBotControlCommand(Player* bot, const std::string& commandStr)
-{
-    if (g_EnableOllamaBotBuddyDebug && bot)
+    bool ExecuteBotCommand(Player* bot, MoveToCommand const& command)
     {
-        LOG_INFO("server.loading", "[OllamaBotBuddy] ParseBotControlCommand for '{}': {}", bot->GetName(), commandStr);
+        return BotBuddyAI::MoveTo(bot, command.x, command.y, command.z);
     }
-    std::istringstream iss(commandStr);
-    std::string cmd;
-    iss >> cmd;
-    if (cmd == "move")
+
+    bool ExecuteBotCommand(Player* bot, AttackCommand const& command)
     {
-        std::string to;
-        iss >> to;
-        if (to != "to") return false;
-        float x, y, z;
-        iss >> x >> y >> z;
-        BotControlCommand command = {BotControlCommandType::MoveTo, {std::to_string(x), std::to_string(y), std::to_string(z)}};
-        bool result = HandleBotControlCommand(bot, command);
-        if (result)
+        // Creature from the bot's snapshot first, then Player
+        if (Unit* target = ResolveBotUnit(bot, command.guid))
         {
-            AddBotCommandHistory(bot, FormatCommandString(command));
+            // Use the actual GUID from the target, never reconstruct!
+            return BotBuddyAI::Attack(bot, target->GetGUID());
         }
-        return result;
+
+        LOG_INFO("server.loading", "[OllamaBotBuddy] Could not find target with lowGuid {}", command.guid);
+        return false;
     }
-    else if (cmd == "attack")
+
+    bool ExecuteBotCommand(Player* bot, InteractCommand const& command)
     {
-        std::string guid;
-        iss >> guid;
-        BotControlCommand command = {BotControlCommandType::Attack, {guid}};
-        bool result = HandleBotControlCommand(bot, command);
-        if (result)
+        if (Creature* creatureTarget = ResolveBotCreature(bot, command.guid))
         {
-            AddBotCommandHistory(bot, FormatCommandString(command));
+            return BotBuddyAI::Interact(bot, creatureTarget->GetGUID());
         }
-        return result;
-    }
-    else if (cmd == "interact")
-    {
-        std::string guid;
-        iss >> guid;
-        BotControlCommand command = {BotControlCommandType::Interact, {guid}};
-        bool result = HandleBotControlCommand(bot, command);
-        if (result)
+
+        if (GameObject* goTarget = ResolveBotGameObject(bot, command.guid))
         {
-            AddBotCommandHistory(bot, FormatCommandString(command));
+            return BotBuddyAI::Interact(bot, goTarget->GetGUID());
         }
-        return result;
+
+        LOG_INFO("server.loading", "[OllamaBotBuddy] Could not find interact target with lowGuid {}", command.guid);
+        return false;
     }
-    else if (cmd == "say")
+
+    bool ExecuteBotCommand(Player* bot, CastSpellCommand const& command)
     {
-        std::string msg;
-        std::getline(iss, msg);
-        BotControlCommand command = {BotControlCommandType::Say, {msg}};
-        bool result = HandleBotControlCommand(bot, command);
-        if (result)
-        {
-            AddBotCommandHistory(bot, FormatCommandString(command));
-        }
-        return result;
+        // Creature from the bot's snapshot first, then Player. Use bot itself as the target if no guid provided
+        Unit* target = command.guid ? ResolveBotUnit(bot, command.guid) : bot;
+        return BotBuddyAI::CastSpell(bot, command.spellId, target);
     }
-    else if (cmd == "loot")
+
+    bool ExecuteBotCommand(Player* bot, LootCommand const& /*command*/)
     {
-        BotControlCommand command = {BotControlCommandType::Loot, {}};
-        bool result = HandleBotControlCommand(bot, command);
-        if (result)
-        {
-            AddBotCommandHistory(bot, FormatCommandString(command));
-        }
-        return result;
+        return BotBuddyAI::LootNearby(bot);
     }
-    else if (cmd == "follow")
+
+    bool ExecuteBotCommand(Player* bot, FollowCommand const& /*command*/)
     {
-        BotControlCommand command = {BotControlCommandType::Follow, {}};
-        bool result = HandleBotControlCommand(bot, command);
-        if (result)
-        {
-            AddBotCommandHistory(bot, FormatCommandString(command));
-        }
-        return result;
+        return BotBuddyAI::FollowMaster(bot);
     }
-    else if (cmd == "stop")
+
+    bool ExecuteBotCommand(Player* bot, SayCommand const& command)
     {
-        BotControlCommand command = {BotControlCommandType::Stop, {}};
-        bool result = HandleBotControlCommand(bot, command);
-        if (result)
-        {
-            AddBotCommandHistory(bot, FormatCommandString(command));
-        }
-        return result;
+        return !command.text.empty() && BotBuddyAI::Say(bot, command.text);
     }
-    else if (cmd == "acceptquest")
+
+    bool ExecuteBotCommand(Player* bot, AcceptQuestCommand const& command)
     {
-        uint32 questId;
-        iss >> questId;
-        BotControlCommand command = {BotControlCommandType::AcceptQuest, {std::to_string(questId)}};
-        bool result = HandleBotControlCommand(bot, command);
-        if (result)
-        {
-            AddBotCommandHistory(bot, FormatCommandString(command));
-        }
-        return result;
+        return BotBuddyAI::AcceptQuest(bot, command.questId);
     }
-    else if (cmd == "turninquest")
+
+    bool ExecuteBotCommand(Player* bot, TurnInQuestCommand const& command)
     {
-        uint32 questId;
-        iss >> questId;
-        BotControlCommand command = {BotControlCommandType::TurnInQuest, {std::to_string(questId)}};
-        bool result = HandleBotControlCommand(bot, command);
-        if (result)
-        {
-            AddBotCommandHistory(bot, FormatCommandString(command));
-        }
-        return result;
+        return BotBuddyAI::TurnInQuest(bot, command.questId);
     }
-    else if (cmd == "spell")
+
+    // Text form arguments are the params in order, optional ones are left out when unset
+    template<typename Command>
+    void WriteBotCommandArgs(std::ostream& out, Command const& command)
     {
-        uint32 spellId;
-        iss >> spellId;
-        std::string targetGuid;
-        iss >> targetGuid;
-        BotControlCommand command;
-        if (!targetGuid.empty())
-        {
-            command = {BotControlCommandType::CastSpell, {std::to_string(spellId), targetGuid}};
-        }
-        else
+        for (BotCommandParam<Command> const& param : BotCommandTraits<Command>::Params)
         {
-            command = {BotControlCommandType::CastSpell, {std::to_string(spellId)}};
+            if (param.type == BotCommandParamType::Number)
+                out << ' ' << command.*param.number;
+            else if (!param.optional || command.*param.integer)
+                out << ' ' << command.*param.integer;
         }
-        bool result = HandleBotControlCommand(bot, command);
-        if (result)
+    }
+
+    void WriteBotCommandArgs(std::ostream& out, SayCommand const& command)
+    {
+        out << ' ' << command.text;
+    }
+
+    // Every required param must be there and nothing may follow the last one,
+    // so "attack abc" is rejected instead of attacking GUID 0
+    template<typename Command>
+    bool ReadBotCommandArgs(std::istream& in, Command& command)
+    {
+        for (BotCommandParam<Command> const& param : BotCommandTraits<Command>::Params)
         {
-            AddBotCommandHistory(bot, FormatCommandString(command));
+            // Optional params can only be left out at the end
+            if (param.optional && (in >> std::ws).eof())
+                break;
+
+            if (param.type == BotCommandParamType::Number)
+                in >> command.*param.number;
+            else
+            {
+                // Extracting into the uint32 would wrap "-1" around, same range as BuildBotCommand
+                int64 value = 0;
+                in >> value;
+                if (value < 0 || value > int64(std::numeric_limits<uint32>::max()))
+                    return false;
+                command.*param.integer = uint32(value);
+            }
+            if (in.fail())
+                return false;
         }
-        return result;
+        return (in >> std::ws).eof();
+    }
+
+    bool ReadBotCommandArgs(std::istream& in, SayCommand& command)
+    {
+        in >> std::ws;
+        std::getline(in, command.text);
+        return true;
+    }
+
+    // Keyword of the text form, followed by the arguments or nothing
+    bool MatchBotCommandKeyword(std::string_view text, std::string_view keyword)
+    {
+        return text.substr(0, keyword.size()) == keyword && (text.size() == keyword.size() || text[keyword.size()] == ' ');
+    }
+
+    template<typename Command, typename = void>
+    struct HasBotCommandTextAlias : std::false_type {};
+
+    template<typename Command>
+    struct HasBotCommandTextAlias<Command, std::void_t<decltype(BotCommandTraits<Command>::TextAlias)>> : std::true_type {};
+
+    template<typename Command>
+    bool TryParseBotCommandText(std::string_view text, BotControlCommand& command)
+    {
+        std::string_view keyword = BotCommandTraits<Command>::Text;
+        if constexpr (HasBotCommandTextAlias<Command>::value)
+            if (!MatchBotCommandKeyword(text, keyword))
+                keyword = BotCommandTraits<Command>::TextAlias;
+        if (!MatchBotCommandKeyword(text, keyword))
+            return false;
+
+        Command parsed;
+        std::istringstream iss(std::string(text.substr(keyword.size())));
+        if (!ReadBotCommandArgs(iss, parsed))
+            return false;
+        command = std::move(parsed);
+        return true;
+    }
+
+    template<size_t... I>
+    bool ParseBotCommandText(std::string_view text, BotControlCommand& command, std::index_sequence<I...>)
+    {
+        return (TryParseBotCommandText<std::variant_alternative_t<I, BotControlCommand>>(text, command) || ...);
     }
-    return false;
 }
 
-std::string FormatCommandString(const BotControlCommand& command)
+bool HandleBotControlCommand(Player* bot, const BotControlCommand& command)
 {
-    std::ostringstream ss;
-    switch (command.type)
+    if (g_EnableOllamaBotBuddyDebug && bot)
     {
-        case BotControlCommandType::MoveTo:
-            ss << "move to";
-            for (const auto& arg : command.args)
-                ss << " " << arg;
-            break;
-        case BotControlCommandType::Attack:
-            ss << "attack";
-            for (const auto& arg : command.args)
-                ss << " " << arg;
-            break;
-        case BotControlCommandType::Interact:
-            ss << "interact";
-            for (const auto& arg : command.args)
-                ss << " " << arg;
-            break;
-        case BotControlCommandType::CastSpell:
-            ss << "cast";
-            for (const auto& arg : command.args)
-                ss << " " << arg;
-            break;
-        case BotControlCommandType::Loot:
-            ss << "loot";
-            break;
-        case BotControlCommandType::Follow:
-            ss << "follow";
-            break;
-        case BotControlCommandType::Say:
-            ss << "say";
-            for (const auto& arg : command.args)
-                ss << " " << arg;
-            break;
-        case BotControlCommandType::AcceptQuest:
-            ss << "acceptquest";
-            for (const auto& arg : command.args)
-                ss << " " << arg;
-            break;
-        case BotControlCommandType::TurnInQuest:
-            ss << "turninquest";
-            for (const auto& arg : command.args)
-                ss << " " << arg;
-            break;
-        case BotControlCommandType::Stop:
-            ss << "stop";
-            break;
-        default:
-            ss << "unknown command";
-            for (const auto& arg : command.args)
-                ss << " " << arg;
-            break;
+        LOG_INFO("server.loading", "[OllamaBotBuddy] HandleBotControlCommand for '{}': {}", bot->GetName(), FormatCommandString(command));
+        LOG_INFO("server.loading", "[OllamaBotBuddy] ================================================================================================");
     }
-    return ss.str();
+    if (!bot) return false;
+    BotStageTimer timer(BotLatencyStage::Execute);
+    return std::visit([bot](auto const& payload) { return ExecuteBotCommand(bot, payload); }, command);
 }
 
+bool ParseBotControlCommand(Player* bot, const std::string& commandStr)
+{
+    if (g_EnableOllamaBotBuddyDebug && bot)
+    {
+        LOG_INFO("server.loading", "[OllamaBotBuddy] ParseBotControlCommand for '{}': {}", bot->GetName(), commandStr);
+    }
+
+    BotControlCommand command;
+    if (!ParseBotCommandText(commandStr, command, std::make_index_sequence<std::variant_size_v<BotControlCommand>>()))
+        return false;
 
+    bool result = HandleBotControlCommand(bot, command);
+    if (result)
+    {
+        AddBotCommandHistory(bot, FormatCommandString(command));
+    }
+    return result;
+}
+
+std::string FormatCommandString(const BotControlCommand& command)
+{
+    std::ostringstream ss;
+    std::visit([&ss](auto const& payload) {
+        using Command = std::decay_t<decltype(payload)>;
+        ss << BotCommandTraits<Command>::Text;
+        WriteBotCommandArgs(ss, payload);
+    }, command);
+    return ss.str();
+}
@@ -1,29 +1,184 @@
 #pragma once
 #include "Player.h"
+#include <array>
 #include <string>
+#include <variant>
 #include <vector>
 
-enum class BotControlCommandType
+// One struct per command, holding exactly the typed values it needs
+struct StopCommand {};
+
+struct MoveToCommand
+{
+    float x = 0.0f;
+    float y = 0.0f;
+    float z = 0.0f;
+};
+
+struct AttackCommand
+{
+    uint32 guid = 0;  // low GUID from the bot's snapshot
+};
+
+struct InteractCommand
+{
+    uint32 guid = 0;
+};
+
+struct CastSpellCommand
+{
+    uint32 spellId = 0;
+    uint32 guid = 0;  // 0 casts on the bot itself
+};
+
+struct LootCommand {};
+struct FollowCommand {};
+
+struct SayCommand
+{
+    std::string text;
+};
+
+struct AcceptQuestCommand
+{
+    uint32 questId = 0;
+};
+
+struct TurnInQuestCommand
+{
+    uint32 questId = 0;
+};
+
+// Default constructs to Stop
+using BotControlCommand = std::variant<StopCommand, MoveToCommand, AttackCommand, InteractCommand, CastSpellCommand,
+    LootCommand, FollowCommand, SayCommand, AcceptQuestCommand, TurnInQuestCommand>;
+
+enum class BotCommandParamType
+{
+    Number,
+    Integer
+};
+
+template<typename Command>
+struct BotCommandParam
+{
+    char const* name;
+    BotCommandParamType type;
+    bool optional;
+    char const* note;                    // appended in the rules prompt, may be null
+    float Command::* number = nullptr;   // field of a Number param
+    uint32 Command::* integer = nullptr; // field of an Integer param
+};
+
+// Describes a command to the generic code: Name is its type in LLM replies,
+// Text the keyword of its text form ("move to 1 2 3") used by the history and
+// ParseBotControlCommand, TextAlias an optional second keyword the parser also
+// accepts, and Params its values in order. Adding a command
+// means a struct, its traits, an ExecuteBotCommand overload and an entry in
+// BotControlCommand (and in BotLlmCommands if the LLM may use it).
+template<typename Command>
+struct BotCommandTraits;
+
+template<>
+struct BotCommandTraits<StopCommand>
+{
+    static constexpr char const* Name = "stop";
+    static constexpr char const* Text = "stop";
+    static constexpr std::array<BotCommandParam<StopCommand>, 0> Params = {};
+};
+
+template<>
+struct BotCommandTraits<MoveToCommand>
+{
+    static constexpr char const* Name = "move_to";
+    static constexpr char const* Text = "move to";
+    static constexpr std::array<BotCommandParam<MoveToCommand>, 3> Params = { {
+        { "x", BotCommandParamType::Number, false, nullptr, &MoveToCommand::x },
+        { "y", BotCommandParamType::Number, false, nullptr, &MoveToCommand::y },
+        { "z", BotCommandParamType::Number, false, nullptr, &MoveToCommand::z },
+    } };
+};
+
+template<>
+struct BotCommandTraits<AttackCommand>
+{
+    static constexpr char const* Name = "attack";
+    static constexpr char const* Text = "attack";
+    static constexpr std::array<BotCommandParam<AttackCommand>, 1> Params = { {
+        { "guid", BotCommandParamType::Integer, false, nullptr, nullptr, &AttackCommand::guid },
+    } };
+};
+
+template<>
+struct BotCommandTraits<InteractCommand>
+{
+    static constexpr char const* Name = "interact";
+    static constexpr char const* Text = "interact";
+    static constexpr std::array<BotCommandParam<InteractCommand>, 1> Params = { {
+        { "guid", BotCommandParamType::Integer, false, nullptr, nullptr, &InteractCommand::guid },
+    } };
+};
+
+template<>
+struct BotCommandTraits<CastSpellCommand>
+{
+    static constexpr char const* Name = "spell";
+    static constexpr char const* Text = "cast";
+    static constexpr char const* TextAlias = "spell";  // documented form of chat and API commands
+    static constexpr std::array<BotCommandParam<CastSpellCommand>, 2> Params = { {
+        { "spellid", BotCommandParamType::Integer, false, nullptr, nullptr, &CastSpellCommand::spellId },
+        { "guid", BotCommandParamType::Integer, true, "omit if self-cast", nullptr, &CastSpellCommand::guid },
+    } };
+};
+
+template<>
+struct BotCommandTraits<LootCommand>
+{
+    static constexpr char const* Name = "loot";
+    static constexpr char const* Text = "loot";
+    static constexpr std::array<BotCommandParam<LootCommand>, 0> Params = {};
+};
+
+template<>
+struct BotCommandTraits<FollowCommand>
+{
+    static constexpr char const* Name = "follow";
+    static constexpr char const* Text = "follow";
+    static constexpr std::array<BotCommandParam<FollowCommand>, 0> Params = {};
+};
+
+// Not offered to the LLM, replies carry their text in the top-level "say" field
+template<>
+struct BotCommandTraits<SayCommand>
+{
+    static constexpr char const* Name = "say";
+    static constexpr char const* Text = "say";
+    static constexpr std::array<BotCommandParam<SayCommand>, 0> Params = {};
+};
+
+template<>
+struct BotCommandTraits<AcceptQuestCommand>
 {
-    MoveTo,
-    Attack,
-    Interact,
-    CastSpell,
-    Loot,
-    Follow,
-    Say,
-    AcceptQuest,
-    TurnInQuest,
-    Stop
+    static constexpr char const* Name = "accept_quest";
+    static constexpr char const* Text = "acceptquest";
+    static constexpr std::array<BotCommandParam<AcceptQuestCommand>, 1> Params = { {
+        { "id", BotCommandParamType::Integer, false, nullptr, nullptr, &AcceptQuestCommand::questId },
+    } };
 };
 
-struct BotControlCommand
+template<>
+struct BotCommandTraits<TurnInQuestCommand>
 {
-    BotControlCommandType type;
-    std::vector<std::string> args;
+    static constexpr char const* Name = "turn_in_quest";
+    static constexpr char const* Text = "turninquest";
+    static constexpr std::array<BotCommandParam<TurnInQuestCommand>, 1> Params = { {
+        { "id", BotCommandParamType::Integer, false, nullptr, nullptr, &TurnInQuestCommand::questId },
+    } };
 };
 
 bool HandleBotControlCommand(Player* bot, const BotControlCommand& command);
+// Parses and runs a command in its text form, e.g. "move to 1 2 3" or "spell 133 2241",
+// returns false for an unknown keyword, a missing or malformed value or trailing text
 bool ParseBotControlCommand(Player* bot, const std::string& commandStr);
 
 std::string FormatCommandString(const BotControlCommand& command);
@@ -0,0 +1,99 @@
+#include "mod-ollama-bot-buddy_commands.h"
+#include "mod-ollama-bot-buddy_registry.h"
+#include "mod-ollama-bot-buddy_stats.h"
+#include "ObjectAccessor.h"
+#include "Player.h"
+#include "PlayerbotAI.h"
+#include "PlayerbotMgr.h"
+
+ChatCommandTable BotBuddyCommandScript::GetCommands() const
+{
+    static ChatCommandTable buddyCommandTable =
+    {
+        { "control", HandleBuddyControlCommand, SEC_GAMEMASTER, Console::Yes },
+        { "release", HandleBuddyReleaseCommand, SEC_GAMEMASTER, Console::Yes },
+        { "list",    HandleBuddyListCommand,    SEC_GAMEMASTER, Console::Yes },
+        { "stats",   HandleBuddyStatsCommand,   SEC_GAMEMASTER, Console::Yes }
+    };
+
+    static ChatCommandTable commandTable =
+    {
+        { "buddy", buddyCommandTable }
+    };
+
+    return commandTable;
+}
+
+static Player* GetBuddyCommandTarget(ChatHandler* handler, Optional<PlayerIdentifier>& target)
+{
+    if (!target)
+        target = PlayerIdentifier::FromTargetOrSelf(handler);
+
+    Player* bot = target ? target->GetConnectedPlayer() : nullptr;
+    if (!bot)
+    {
+        handler->SendErrorMessage("Player not found or not online.");
+        return nullptr;
+    }
+    return bot;
+}
+
+bool BotBuddyCommandScript::HandleBuddyControlCommand(ChatHandler* handler, Optional<PlayerIdentifier> target)
+{
+    Player* bot = GetBuddyCommandTarget(handler, target);
+    if (!bot)
+        return false;
+
+    PlayerbotAI* ai = sPlayerbotsMgr->GetPlayerbotAI(bot);
+    if (!ai || !ai->IsBotAI())
+    {
+        handler->SendErrorMessage("{} is not a bot.", bot->GetName());
+        return false;
+    }
+
+    if (IsControlledBot(bot->GetGUID()))
+    {
+        handler->PSendSysMessage("{} is already LLM-controlled.", bot->GetName());
+        return true;
+    }
+
+    AddControlledBot(bot);
+    handler->PSendSysMessage("{} is now LLM-controlled.", bot->GetName());
+    return true;
+}
+
+bool BotBuddyCommandScript::HandleBuddyReleaseCommand(ChatHandler* handler, Optional<PlayerIdentifier> target)
+{
+    Player* bot = GetBuddyCommandTarget(handler, target);
+    if (!bot)
+        return false;
+
+    if (!ReleaseControlledBot(bot))
+    {
+        handler->SendErrorMessage("{} is not LLM-controlled.", bot->GetName());
+        return false;
+    }
+
+    handler->PSendSysMessage("{} is back on its normal Playerbot strategies.", bot->GetName());
+    return true;
+}
+
+bool BotBuddyCommandScript::HandleBuddyListCommand(ChatHandler* handler)
+{
+    auto const& bots = GetControlledBots();
+    handler->PSendSysMessage("LLM-controlled bots: {}", bots.size());
+    for (auto const& [guid, entry] : bots)
+    {
+        Player* bot = ObjectAccessor::FindConnectedPlayer(entry.guid);
+        handler->PSendSysMessage("  {}{}", bot ? bot->GetName() : entry.guid.ToString(), entry.takenOver ? "" : " (waiting for its AI)");
+    }
+    return true;
+}
+
+bool BotBuddyCommandScript::HandleBuddyStatsCommand(ChatHandler* handler)
+{
+    handler->SendSysMessage("LLM decision stats since startup:");
+    for (std::string const& line : FormatBotStats())
+        handler->PSendSysMessage("  {}", line);
+    return true;
+}
@@ -0,0 +1,20 @@
+#pragma once
+#include "ScriptMgr.h"
+#include "Chat.h"
+#include "ChatCommand.h"
+
+using namespace Acore::ChatCommands;
+
+// .buddy control/release/list, hands bots to the LLM at runtime, and .buddy stats
+class BotBuddyCommandScript : public CommandScript
+{
+public:
+    BotBuddyCommandScript() : CommandScript("BotBuddyCommandScript") {}
+
+    ChatCommandTable GetCommands() const override;
+
+    static bool HandleBuddyControlCommand(ChatHandler* handler, Optional<PlayerIdentifier> target);
+    static bool HandleBuddyReleaseCommand(ChatHandler* handler, Optional<PlayerIdentifier> target);
+    static bool HandleBuddyListCommand(ChatHandler* handler);
+    static bool HandleBuddyStatsCommand(ChatHandler* handler);
+};
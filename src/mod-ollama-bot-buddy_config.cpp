@@ -4,8 +4,48 @@
 bool g_EnableOllamaBotControl = true;
 std::string g_OllamaBotControlUrl = "http://localhost:11434/api/generate";
 std::string g_OllamaBotControlModel = "llama3.2:1b";
+std::string g_OllamaBotControlBackends = "";
+uint32 g_OllamaBotControlHealthCheckInterval = 10;
 bool g_EnableOllamaBotBuddyDebug = false;
 bool g_EnableBotBuddyAddon = false;
+uint32 g_OllamaBotControlWorkerThreads = 4;
+uint32 g_OllamaBotControlMaxQueuedRequests = 64;
+uint32 g_OllamaBotControlMaxInFlightRequests = 32;
+uint32 g_OllamaBotControlRequestTimeout = 120;
+bool g_OllamaBotControlStreamEarlyAbort = true;
+uint32 g_OllamaBotControlStreamAbortTrailingChars = 256;
+uint32 g_OllamaBotControlMaxCommandsPerTick = 100;
+uint32 g_OllamaBotControlCommandBudgetMs = 5;
+uint32 g_OllamaBotControlLosCacheTTL = 5000;
+float g_OllamaBotControlLosCacheMoveThreshold = 2.0f;
+bool g_OllamaBotControlSession = false;
+uint32 g_OllamaBotControlSessionMaxTokens = 3072;
+bool g_OllamaBotControlDeltaPrompts = false;
+uint32 g_OllamaBotControlDeltaKeyframeInterval = 10;
+uint32 g_OllamaBotControlLocationsTokenBudget = 800;
+uint32 g_OllamaBotControlWaypointsTokenBudget = 250;
+uint32 g_OllamaBotControlPlayersTokenBudget = 250;
+uint32 g_OllamaBotControlContextWindow = 0;
+std::string g_OllamaBotControlKeepAlive = "30m";
+bool g_OllamaBotControlStructuredOutput = true;
+uint32 g_OllamaBotControlNumPredict = 256;
+float g_OllamaBotControlTemperature = 0.4f;
+uint32 g_OllamaBotControlWaypointIndexCheckInterval = 300;
+std::string g_OllamaBotControlControlledBotNames = "Ollamatest";
+std::string g_OllamaBotControlControlledBotGuids = "";
+std::string g_OllamaBotControlControlledBotAccountPattern = "";
+uint32 g_OllamaBotControlRandomBotPercent = 0;
+uint32 g_OllamaBotControlCombatDecisionInterval = 1000;
+uint32 g_OllamaBotControlTravelDecisionInterval = 4000;
+uint32 g_OllamaBotControlIdleDecisionInterval = 8000;
+uint32 g_OllamaBotControlDecisionCacheSize = 0;
+uint32 g_OllamaBotControlDecisionCacheTTL = 30000;
+float g_OllamaBotControlDecisionCachePositionBucket = 10.0f;
+uint32 g_OllamaBotControlBatchSize = 0;
+uint32 g_OllamaBotControlBatchWindowMs = 50;
+std::string g_OllamaBotControlReflexes = "";
+float g_OllamaBotControlReflexFollowDistance = 30.0f;
+uint32 g_OllamaBotControlStatusLogInterval = 60;
 
 OllamaBotControlConfigWorldScript::OllamaBotControlConfigWorldScript() : WorldScript("OllamaBotControlConfigWorldScript") {}
 
@@ -14,6 +54,46 @@ void OllamaBotControlConfigWorldScript::OnStartup()
     g_EnableOllamaBotControl = sConfigMgr->GetOption<bool>("OllamaBotControl.Enable", true);
     g_OllamaBotControlUrl = sConfigMgr->GetOption<std::string>("OllamaBotControl.Url", "http://localhost:11434/api/generate");
     g_OllamaBotControlModel = sConfigMgr->GetOption<std::string>("OllamaBotControl.Model", "llama3.2:1b");
+    g_OllamaBotControlBackends = sConfigMgr->GetOption<std::string>("OllamaBotControl.Backends", "");
+    g_OllamaBotControlHealthCheckInterval = sConfigMgr->GetOption<uint32>("OllamaBotControl.HealthCheckInterval", 10);
     g_EnableOllamaBotBuddyDebug = sConfigMgr->GetOption<bool>("OllamaBotControl.Debug", false);
     g_EnableBotBuddyAddon = sConfigMgr->GetOption<bool>("OllamaBotControl.EnableBotBuddyAddon", false);
+    g_OllamaBotControlWorkerThreads = sConfigMgr->GetOption<uint32>("OllamaBotControl.WorkerThreads", 4);
+    g_OllamaBotControlMaxQueuedRequests = sConfigMgr->GetOption<uint32>("OllamaBotControl.MaxQueuedRequests", 64);
+    g_OllamaBotControlMaxInFlightRequests = sConfigMgr->GetOption<uint32>("OllamaBotControl.MaxInFlightRequests", 32);
+    g_OllamaBotControlRequestTimeout = sConfigMgr->GetOption<uint32>("OllamaBotControl.RequestTimeout", 120);
+    g_OllamaBotControlStreamEarlyAbort = sConfigMgr->GetOption<bool>("OllamaBotControl.StreamEarlyAbort", true);
+    g_OllamaBotControlStreamAbortTrailingChars = sConfigMgr->GetOption<uint32>("OllamaBotControl.StreamAbortTrailingChars", 256);
+    g_OllamaBotControlMaxCommandsPerTick = sConfigMgr->GetOption<uint32>("OllamaBotControl.MaxCommandsPerTick", 100);
+    g_OllamaBotControlCommandBudgetMs = sConfigMgr->GetOption<uint32>("OllamaBotControl.CommandBudgetMs", 5);
+    g_OllamaBotControlLosCacheTTL = sConfigMgr->GetOption<uint32>("OllamaBotControl.LosCacheTTL", 5000);
+    g_OllamaBotControlLosCacheMoveThreshold = sConfigMgr->GetOption<float>("OllamaBotControl.LosCacheMoveThreshold", 2.0f);
+    g_OllamaBotControlSession = sConfigMgr->GetOption<bool>("OllamaBotControl.Session", false);
+    g_OllamaBotControlSessionMaxTokens = sConfigMgr->GetOption<uint32>("OllamaBotControl.SessionMaxTokens", 3072);
+    g_OllamaBotControlDeltaPrompts = sConfigMgr->GetOption<bool>("OllamaBotControl.DeltaPrompts", false);
+    g_OllamaBotControlDeltaKeyframeInterval = sConfigMgr->GetOption<uint32>("OllamaBotControl.DeltaKeyframeInterval", 10);
+    g_OllamaBotControlLocationsTokenBudget = sConfigMgr->GetOption<uint32>("OllamaBotControl.LocationsTokenBudget", 800);
+    g_OllamaBotControlWaypointsTokenBudget = sConfigMgr->GetOption<uint32>("OllamaBotControl.WaypointsTokenBudget", 250);
+    g_OllamaBotControlPlayersTokenBudget = sConfigMgr->GetOption<uint32>("OllamaBotControl.PlayersTokenBudget", 250);
+    g_OllamaBotControlContextWindow = sConfigMgr->GetOption<uint32>("OllamaBotControl.ContextWindow", 0);
+    g_OllamaBotControlKeepAlive = sConfigMgr->GetOption<std::string>("OllamaBotControl.KeepAlive", "30m");
+    g_OllamaBotControlStructuredOutput = sConfigMgr->GetOption<bool>("OllamaBotControl.StructuredOutput", true);
+    g_OllamaBotControlNumPredict = sConfigMgr->GetOption<uint32>("OllamaBotControl.NumPredict", 256);
+    g_OllamaBotControlTemperature = sConfigMgr->GetOption<float>("OllamaBotControl.Temperature", 0.4f);
+    g_OllamaBotControlWaypointIndexCheckInterval = sConfigMgr->GetOption<uint32>("OllamaBotControl.WaypointIndexCheckInterval", 300);
+    g_OllamaBotControlControlledBotNames = sConfigMgr->GetOption<std::string>("OllamaBotControl.ControlledBotNames", "Ollamatest");
+    g_OllamaBotControlControlledBotGuids = sConfigMgr->GetOption<std::string>("OllamaBotControl.ControlledBotGuids", "");
+    g_OllamaBotControlControlledBotAccountPattern = sConfigMgr->GetOption<std::string>("OllamaBotControl.ControlledBotAccountPattern", "");
+    g_OllamaBotControlRandomBotPercent = sConfigMgr->GetOption<uint32>("OllamaBotControl.RandomBotPercent", 0);
+    g_OllamaBotControlCombatDecisionInterval = sConfigMgr->GetOption<uint32>("OllamaBotControl.CombatDecisionInterval", 1000);
+    g_OllamaBotControlTravelDecisionInterval = sConfigMgr->GetOption<uint32>("OllamaBotControl.TravelDecisionInterval", 4000);
+    g_OllamaBotControlIdleDecisionInterval = sConfigMgr->GetOption<uint32>("OllamaBotControl.IdleDecisionInterval", 8000);
+    g_OllamaBotControlDecisionCacheSize = sConfigMgr->GetOption<uint32>("OllamaBotControl.DecisionCacheSize", 0);
+    g_OllamaBotControlDecisionCacheTTL = sConfigMgr->GetOption<uint32>("OllamaBotControl.DecisionCacheTTL", 30000);
+    g_OllamaBotControlDecisionCachePositionBucket = sConfigMgr->GetOption<float>("OllamaBotControl.DecisionCachePositionBucket", 10.0f);
+    g_OllamaBotControlBatchSize = sConfigMgr->GetOption<uint32>("OllamaBotControl.BatchSize", 0);
+    g_OllamaBotControlBatchWindowMs = sConfigMgr->GetOption<uint32>("OllamaBotControl.BatchWindowMs", 50);
+    g_OllamaBotControlReflexes = sConfigMgr->GetOption<std::string>("OllamaBotControl.Reflexes", "");
+    g_OllamaBotControlReflexFollowDistance = sConfigMgr->GetOption<float>("OllamaBotControl.ReflexFollowDistance", 30.0f);
+    g_OllamaBotControlStatusLogInterval = sConfigMgr->GetOption<uint32>("OllamaBotControl.StatusLogInterval", 60);
 }
@@ -5,8 +5,48 @@
 extern bool g_EnableOllamaBotControl;
 extern std::string g_OllamaBotControlUrl;
 extern std::string g_OllamaBotControlModel;
+extern std::string g_OllamaBotControlBackends;
+extern uint32 g_OllamaBotControlHealthCheckInterval;
 extern bool g_EnableOllamaBotBuddyDebug;
 extern bool g_EnableBotBuddyAddon;
+extern uint32 g_OllamaBotControlWorkerThreads;
+extern uint32 g_OllamaBotControlMaxQueuedRequests;
+extern uint32 g_OllamaBotControlMaxInFlightRequests;
+extern uint32 g_OllamaBotControlRequestTimeout;
+extern bool g_OllamaBotControlStreamEarlyAbort;
+extern uint32 g_OllamaBotControlStreamAbortTrailingChars;
+extern uint32 g_OllamaBotControlMaxCommandsPerTick;
+extern uint32 g_OllamaBotControlCommandBudgetMs;
+extern uint32 g_OllamaBotControlLosCacheTTL;
+extern float g_OllamaBotControlLosCacheMoveThreshold;
+extern bool g_OllamaBotControlSession;
+extern uint32 g_OllamaBotControlSessionMaxTokens;
+extern bool g_OllamaBotControlDeltaPrompts;
+extern uint32 g_OllamaBotControlDeltaKeyframeInterval;
+extern uint32 g_OllamaBotControlLocationsTokenBudget;
+extern uint32 g_OllamaBotControlWaypointsTokenBudget;
+extern uint32 g_OllamaBotControlPlayersTokenBudget;
+extern uint32 g_OllamaBotControlContextWindow;
+extern std::string g_OllamaBotControlKeepAlive;
+extern bool g_OllamaBotControlStructuredOutput;
+extern uint32 g_OllamaBotControlNumPredict;
+extern float g_OllamaBotControlTemperature;
+extern uint32 g_OllamaBotControlWaypointIndexCheckInterval;
+extern std::string g_OllamaBotControlControlledBotNames;
+extern std::string g_OllamaBotControlControlledBotGuids;
+extern std::string g_OllamaBotControlControlledBotAccountPattern;
+extern uint32 g_OllamaBotControlRandomBotPercent;
+extern uint32 g_OllamaBotControlCombatDecisionInterval;
+extern uint32 g_OllamaBotControlTravelDecisionInterval;
+extern uint32 g_OllamaBotControlIdleDecisionInterval;
+extern uint32 g_OllamaBotControlDecisionCacheSize;
+extern uint32 g_OllamaBotControlDecisionCacheTTL;
+extern float g_OllamaBotControlDecisionCachePositionBucket;
+extern uint32 g_OllamaBotControlBatchSize;
+extern uint32 g_OllamaBotControlBatchWindowMs;
+extern std::string g_OllamaBotControlReflexes;
+extern float g_OllamaBotControlReflexFollowDistance;
+extern uint32 g_OllamaBotControlStatusLogInterval;
 
 class OllamaBotControlConfigWorldScript : public WorldScript
 {
@@ -0,0 +1,146 @@
+#include "mod-ollama-bot-buddy_decisions.h"
+#include "mod-ollama-bot-buddy_config.h"
+#include "Player.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <list>
+#include <unordered_map>
+
+namespace
+{
+    struct CachedDecision
+    {
+        uint64 key;
+        uint64 expiresMs;
+        BotControlCommand command;
+    };
+
+    // Most recently used first
+    std::list<CachedDecision> decisionLru;
+    std::unordered_map<uint64, std::list<CachedDecision>::iterator> decisionIndex;
+
+    uint64 decisionCacheHits = 0;
+    uint64 decisionCacheMisses = 0;
+
+    void HashCombine(uint64& seed, uint64 value)
+    {
+        seed ^= value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+    }
+
+    uint64 HashString(std::string const& value)
+    {
+        return std::hash<std::string>()(value);
+    }
+
+    int64 Bucket(float value, float size)
+    {
+        return int64(std::floor(value / size));
+    }
+}
+
+bool IsDecisionCacheEnabled()
+{
+    return g_OllamaBotControlDecisionCacheSize != 0;
+}
+
+uint64 HashBotDecisionState(Player* bot, BotPromptSnapshot const& snapshot)
+{
+    float bucket = std::max(g_OllamaBotControlDecisionCachePositionBucket, 1.0f);
+
+    uint64 key = bot->GetGUID().GetRawValue();
+    HashCombine(key, bot->GetMapId());
+    HashCombine(key, uint64(Bucket(bot->GetPositionX(), bucket)));
+    HashCombine(key, uint64(Bucket(bot->GetPositionY(), bucket)));
+    HashCombine(key, uint64(Bucket(bot->GetPositionZ(), bucket)));
+    HashCombine(key, bot->GetLevel());
+    HashCombine(key, bot->GetMaxHealth() ? uint64(bot->GetHealth()) * 4 / bot->GetMaxHealth() : 0);
+    HashCombine(key, bot->IsInCombat());
+    HashCombine(key, bot->GetVictim() ? bot->GetVictim()->GetGUID().GetRawValue() : 0);
+
+    // Which entities are around matters, their exact HP or distance does not
+    for (PromptSection const& section : snapshot)
+    {
+        bool entitySet = section.name == "locations" || section.name == "players" || section.name == "members";
+        bool quests = section.name == "quests";
+        if (!entitySet && !quests)
+            continue;
+
+        // Order independent, the sections are ordered by relevance
+        uint64 sectionHash = HashString(section.name);
+        uint64 entries = 0;
+        for (PromptEntry const& entry : section.entries)
+            entries += HashString(entitySet ? entry.key : entry.text);
+        HashCombine(sectionHash, entries);
+        HashCombine(key, sectionHash);
+    }
+
+    return key;
+}
+
+BotControlCommand const* FindCachedDecision(uint64 key, uint64 nowMs)
+{
+    auto itr = decisionIndex.find(key);
+    if (itr == decisionIndex.end() || itr->second->expiresMs <= nowMs)
+    {
+        if (itr != decisionIndex.end())
+        {
+            decisionLru.erase(itr->second);
+            decisionIndex.erase(itr);
+        }
+        ++decisionCacheMisses;
+        return nullptr;
+    }
+
+    decisionLru.splice(decisionLru.begin(), decisionLru, itr->second);
+    ++decisionCacheHits;
+    return &itr->second->command;
+}
+
+void StoreCachedDecision(uint64 key, BotDecision const& decision, uint64 nowMs)
+{
+    if (!IsDecisionCacheEnabled())
+        return;
+
+    auto itr = decisionIndex.find(key);
+    if (itr != decisionIndex.end())
+    {
+        decisionLru.erase(itr->second);
+        decisionIndex.erase(itr);
+    }
+
+    // Only the command is replayed, the chat line and the reasoning belong to the moment they were written
+    decisionLru.push_front({ key, nowMs + g_OllamaBotControlDecisionCacheTTL, decision.command });
+    decisionIndex[key] = decisionLru.begin();
+
+    while (decisionLru.size() > g_OllamaBotControlDecisionCacheSize)
+    {
+        decisionIndex.erase(decisionLru.back().key);
+        decisionLru.pop_back();
+    }
+}
+
+void EraseCachedDecision(uint64 key)
+{
+    auto itr = decisionIndex.find(key);
+    if (itr == decisionIndex.end())
+        return;
+
+    decisionLru.erase(itr->second);
+    decisionIndex.erase(itr);
+}
+
+uint64 GetDecisionCacheHits()
+{
+    return decisionCacheHits;
+}
+
+uint64 GetDecisionCacheMisses()
+{
+    return decisionCacheMisses;
+}
+
+size_t GetDecisionCacheSize()
+{
+    return decisionLru.size();
+}
@@ -0,0 +1,22 @@
+#pragma once
+#include "mod-ollama-bot-buddy_loop.h"
+#include "mod-ollama-bot-buddy_prompt.h"
+
+class Player;
+
+// Decisions already taken for a situation, keyed by a hash of the quantized
+// bot state: position bucket, health bucket, combat target, nearby entities,
+// group members and quest states. A bot in a situation it already asked
+// about repeats the command instead of asking the LLM again. Bounded by LRU
+// and expired after OllamaBotControl.DecisionCacheTTL. World thread only.
+bool IsDecisionCacheEnabled();
+
+uint64 HashBotDecisionState(Player* bot, BotPromptSnapshot const& snapshot);
+
+BotControlCommand const* FindCachedDecision(uint64 key, uint64 nowMs);
+void StoreCachedDecision(uint64 key, BotDecision const& decision, uint64 nowMs);
+void EraseCachedDecision(uint64 key);
+
+uint64 GetDecisionCacheHits();
+uint64 GetDecisionCacheMisses();
+size_t GetDecisionCacheSize();
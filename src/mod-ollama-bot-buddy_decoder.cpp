@@ -0,0 +1,413 @@
+#include "mod-ollama-bot-buddy_decoder.h"
+#include "mod-ollama-bot-buddy_schema.h"
+#include <charconv>
+
+namespace
+{
+    // More params than any command takes, extra ones are ignored
+    constexpr size_t MAX_DECODED_PARAMS = 8;
+
+    class JsonCursor
+    {
+    public:
+        JsonCursor(char const* begin, char const* end) : _p(begin), _end(end) {}
+
+        char const* Position() const { return _p; }
+
+        void SkipWhitespace()
+        {
+            while (_p != _end && (*_p == ' ' || *_p == '\t' || *_p == '\n' || *_p == '\r'))
+                ++_p;
+        }
+
+        bool Peek(char c)
+        {
+            SkipWhitespace();
+            return _p != _end && *_p == c;
+        }
+
+        bool Consume(char c)
+        {
+            if (!Peek(c))
+                return false;
+            ++_p;
+            return true;
+        }
+
+        // Moves to the next c outside of any string, used to find the start of the reply's JSON
+        bool SeekTo(char c)
+        {
+            return SeekToAny(std::string_view(&c, 1));
+        }
+
+        // Same for the first of several characters
+        bool SeekToAny(std::string_view chars)
+        {
+            bool inString = false;
+            bool escape = false;
+            for (; _p != _end; ++_p)
+            {
+                if (inString)
+                {
+                    if (escape)
+                        escape = false;
+                    else if (*_p == '\\')
+                        escape = true;
+                    else if (*_p == '"')
+                        inString = false;
+                }
+                else if (chars.find(*_p) != std::string_view::npos)
+                    return true;
+                else if (*_p == '"')
+                    inString = true;
+            }
+            return false;
+        }
+
+        // Content between the quotes, escapes left as they are
+        bool ReadRawString(std::string_view& raw)
+        {
+            if (!Consume('"'))
+                return false;
+            char const* start = _p;
+            for (; _p != _end; ++_p)
+            {
+                if (*_p == '\\')
+                {
+                    if (++_p == _end)
+                        return false;
+                }
+                else if (*_p == '"')
+                {
+                    raw = std::string_view(start, size_t(_p - start));
+                    ++_p;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        bool ReadNumber(double& value)
+        {
+            SkipWhitespace();
+            // from_chars also reads nan, inf and infinity, a JSON number starts with a digit after the optional minus
+            char const* digit = _p != _end && *_p == '-' ? _p + 1 : _p;
+            if (digit == _end || *digit < '0' || *digit > '9')
+                return false;
+            auto [ptr, ec] = std::from_chars(_p, _end, value);
+            if (ec != std::errc() || ptr == _p)
+                return false;
+            _p = ptr;
+            return true;
+        }
+
+        bool SkipValue()
+        {
+            SkipWhitespace();
+            if (_p == _end)
+                return false;
+
+            std::string_view raw;
+            if (*_p == '"')
+                return ReadRawString(raw);
+
+            if (*_p == '{' || *_p == '[')
+            {
+                int depth = 0;
+                do
+                {
+                    if (*_p == '"')
+                    {
+                        if (!ReadRawString(raw))
+                            return false;
+                        continue;
+                    }
+                    if (*_p == '{' || *_p == '[')
+                        ++depth;
+                    else if (*_p == '}' || *_p == ']')
+                        --depth;
+                    ++_p;
+                } while (depth && _p != _end);
+                return depth == 0;
+            }
+
+            // Number, true, false or null
+            char const* start = _p;
+            while (_p != _end && *_p != ',' && *_p != '}' && *_p != ']' && *_p != ' ' && *_p != '\t' && *_p != '\n' && *_p != '\r')
+                ++_p;
+            return _p != start;
+        }
+
+    private:
+        char const* _p;
+        char const* _end;
+    };
+
+    void AppendUtf8(std::string& out, uint32 codePoint)
+    {
+        if (codePoint < 0x80)
+            out += char(codePoint);
+        else if (codePoint < 0x800)
+        {
+            out += char(0xC0 | (codePoint >> 6));
+            out += char(0x80 | (codePoint & 0x3F));
+        }
+        else if (codePoint < 0x10000)
+        {
+            out += char(0xE0 | (codePoint >> 12));
+            out += char(0x80 | ((codePoint >> 6) & 0x3F));
+            out += char(0x80 | (codePoint & 0x3F));
+        }
+        else
+        {
+            out += char(0xF0 | (codePoint >> 18));
+            out += char(0x80 | ((codePoint >> 12) & 0x3F));
+            out += char(0x80 | ((codePoint >> 6) & 0x3F));
+            out += char(0x80 | (codePoint & 0x3F));
+        }
+    }
+
+    bool ReadHex4(std::string_view raw, size_t pos, uint32& value)
+    {
+        if (pos + 4 > raw.size())
+            return false;
+        auto [ptr, ec] = std::from_chars(raw.data() + pos, raw.data() + pos + 4, value, 16);
+        return ec == std::errc() && ptr == raw.data() + pos + 4;
+    }
+
+    // Raw string content as returned by ReadRawString, written to out without its escapes
+    void Unescape(std::string_view raw, std::string& out)
+    {
+        out.clear();
+        if (raw.find('\\') == std::string_view::npos)
+        {
+            out.assign(raw);
+            return;
+        }
+
+        out.reserve(raw.size());
+        for (size_t i = 0; i < raw.size(); ++i)
+        {
+            char c = raw[i];
+            if (c != '\\' || i + 1 == raw.size())
+            {
+                out += c;
+                continue;
+            }
+
+            switch (raw[++i])
+            {
+                case 'n': out += '\n'; break;
+                case 't': out += '\t'; break;
+                case 'r': out += '\r'; break;
+                case 'b': out += '\b'; break;
+                case 'f': out += '\f'; break;
+                case 'u':
+                {
+                    uint32 codePoint = 0;
+                    if (!ReadHex4(raw, i + 1, codePoint))
+                        break;
+                    i += 4;
+                    // Characters outside the BMP come as a surrogate pair
+                    uint32 low = 0;
+                    if (codePoint >= 0xD800 && codePoint < 0xDC00 && i + 2 < raw.size() && raw[i + 1] == '\\' && raw[i + 2] == 'u'
+                        && ReadHex4(raw, i + 3, low) && low >= 0xDC00 && low < 0xE000)
+                    {
+                        codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+                        i += 6;
+                    }
+                    AppendUtf8(out, codePoint);
+                    break;
+                }
+                default:  // \" \\ \/
+                    out += raw[i];
+                    break;
+            }
+        }
+    }
+
+    bool Fail(char const** error, char const* message)
+    {
+        if (error)
+            *error = message;
+        return false;
+    }
+
+    bool DecodeParams(JsonCursor& cursor, BotCommandArg* params, size_t& count, char const** error)
+    {
+        if (!cursor.Consume('{'))
+            return Fail(error, "params is not an object");
+        if (cursor.Consume('}'))
+            return true;
+
+        do
+        {
+            std::string_view name;
+            if (!cursor.ReadRawString(name) || !cursor.Consume(':'))
+                return Fail(error, "malformed params");
+
+            double value = 0.0;
+            if (cursor.ReadNumber(value))
+            {
+                if (count < MAX_DECODED_PARAMS)
+                    params[count++] = { name, value };
+            }
+            else if (!cursor.SkipValue())
+                return Fail(error, "malformed params");
+        } while (cursor.Consume(','));
+
+        return cursor.Consume('}') || Fail(error, "malformed params");
+    }
+
+    bool BuildCommand(std::string_view type, BotCommandArg const* args, size_t count, BotControlCommand& command, char const** error)
+    {
+        for (BotCommandSpec const& spec : GetBotCommandSpecs())
+            if (type == spec.name)
+                return spec.build(args, count, command, error);
+
+        return Fail(error, "unknown command type");
+    }
+
+    bool DecodeCommand(JsonCursor& cursor, BotDecision& decision, char const** error)
+    {
+        cursor.SkipWhitespace();
+        char const* start = cursor.Position();
+        if (!cursor.Consume('{'))
+            return Fail(error, "command is not an object");
+
+        std::string_view type;
+        bool hasType = false;
+        bool hasParams = false;
+        BotCommandArg params[MAX_DECODED_PARAMS];
+        size_t count = 0;
+
+        if (!cursor.Consume('}'))
+        {
+            do
+            {
+                std::string_view key;
+                if (!cursor.ReadRawString(key) || !cursor.Consume(':'))
+                    return Fail(error, "malformed command");
+
+                if (key == "type")
+                {
+                    if (!cursor.ReadRawString(type))
+                        return Fail(error, "command type is not a string");
+                    hasType = true;
+                }
+                else if (key == "params")
+                {
+                    if (!DecodeParams(cursor, params, count, error))
+                        return false;
+                    hasParams = true;
+                }
+                else if (!cursor.SkipValue())
+                    return Fail(error, "malformed command");
+            } while (cursor.Consume(','));
+
+            if (!cursor.Consume('}'))
+                return Fail(error, "malformed command");
+        }
+
+        if (!hasType || !hasParams)
+            return Fail(error, "command needs a type and params");
+
+        decision.commandText.assign(start, size_t(cursor.Position() - start));
+        return BuildCommand(type, params, count, decision.command, error);
+    }
+
+    // Decodes the object at the cursor
+    bool DecodeDecisionObject(JsonCursor& cursor, BotDecision& decision, std::string_view* bot, char const** error)
+    {
+        if (!cursor.Consume('{'))
+            return Fail(error, "no JSON object");
+
+        decision.reasoning.clear();
+        decision.say.clear();
+        bool hasCommand = false;
+
+        if (!cursor.Consume('}'))
+        {
+            do
+            {
+                std::string_view key;
+                if (!cursor.ReadRawString(key) || !cursor.Consume(':'))
+                    return Fail(error, "malformed object");
+
+                std::string_view value;
+                if (key == "command")
+                {
+                    if (!DecodeCommand(cursor, decision, error))
+                        return false;
+                    hasCommand = true;
+                }
+                else if (key == "reasoning" && cursor.Peek('"'))
+                {
+                    cursor.ReadRawString(value);
+                    Unescape(value, decision.reasoning);
+                }
+                else if (key == "say" && cursor.Peek('"'))
+                {
+                    cursor.ReadRawString(value);
+                    Unescape(value, decision.say);
+                }
+                else if (key == "bot" && bot && cursor.Peek('"'))
+                    cursor.ReadRawString(*bot);
+                else if (!cursor.SkipValue())
+                    return Fail(error, "malformed object");
+            } while (cursor.Consume(','));
+
+            if (!cursor.Consume('}'))
+                return Fail(error, "malformed object");
+        }
+
+        return hasCommand || Fail(error, "no command");
+    }
+}
+
+bool DecodeBotDecision(std::string_view text, BotDecision& decision, char const** error)
+{
+    JsonCursor cursor(text.data(), text.data() + text.size());
+    if (!cursor.SeekTo('{'))
+        return Fail(error, "no JSON object");
+    return DecodeDecisionObject(cursor, decision, nullptr, error);
+}
+
+std::vector<DecodedBotDecision> DecodeBotDecisionBatch(std::string_view text)
+{
+    std::vector<DecodedBotDecision> decisions;
+
+    // Whichever comes first outside of quoted text, the array or a lone object.
+    // Brackets of the prose around it, like "[3] bots", do not hold objects and are passed over.
+    JsonCursor cursor(text.data(), text.data() + text.size());
+    while (cursor.SeekToAny("[{"))
+    {
+        if (cursor.Peek('{'))
+        {
+            DecodedBotDecision& entry = decisions.emplace_back();
+            entry.ok = DecodeDecisionObject(cursor, entry.decision, &entry.bot, nullptr);
+            return decisions;
+        }
+
+        cursor.Consume('[');
+        if (cursor.Consume(']'))
+            return decisions;
+        if (!cursor.Peek('{'))
+            continue;
+
+        do
+        {
+            // A broken element is kept as failed and skipped, the ones after it can still be read
+            JsonCursor element = cursor;
+            DecodedBotDecision& entry = decisions.emplace_back();
+            entry.ok = DecodeDecisionObject(element, entry.decision, &entry.bot, nullptr);
+            if (entry.ok)
+                cursor = element;
+            else if (!cursor.SkipValue())
+                break;
+        } while (cursor.Consume(','));
+        return decisions;
+    }
+
+    return decisions;
+}
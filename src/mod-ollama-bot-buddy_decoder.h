@@ -0,0 +1,26 @@
+#pragma once
+#include "mod-ollama-bot-buddy_loop.h"
+#include <string_view>
+#include <vector>
+
+// Single pass decoder for the decision objects an LLM reply contains. It reads
+// the known layout ({"command": {"type", "params"}, "reasoning", "say"}) straight
+// from the reply bytes into a typed BotControlCommand: numbers are converted in
+// place, keys and the command type are compared without copying, and only the
+// strings kept by the decision (reasoning, say, the raw command for the
+// history) are written out. Unknown keys are skipped, braces and quotes inside
+// strings are handled. Safe to call from any thread.
+
+// Decodes the first JSON object of text. On failure error, if given, points to a static description.
+bool DecodeBotDecision(std::string_view text, BotDecision& decision, char const** error = nullptr);
+
+struct DecodedBotDecision
+{
+    std::string_view bot;  // raw "bot" field of a batched reply, empty if missing
+    bool ok = false;
+    BotDecision decision;
+};
+
+// Decodes every object of the first top-level JSON array of text. A lone
+// object counts as an array of one, models sometimes drop the brackets.
+std::vector<DecodedBotDecision> DecodeBotDecisionBatch(std::string_view text);
@@ -1,4 +1,8 @@
 #include "mod-ollama-bot-buddy_handler.h"
+#include "mod-ollama-bot-buddy_names.h"
+#include "mod-ollama-bot-buddy_registry.h"
+#include "mod-ollama-bot-buddy_scheduler.h"
+#include "mod-ollama-bot-buddy_spells.h"
 #include "Log.h"
 #include "PlayerbotAI.h"
 #include "PlayerbotMgr.h"
@@ -8,11 +12,44 @@
 #include <unordered_map>
 #include <deque>
 #include <chrono>
+#include <vector>
 
 // Stores the last messages: [bot GUID][playerName] => pair<text, timestamp>
 std::unordered_map<uint64_t, std::deque<std::pair<std::string, std::string>>> botPlayerMessages;
 std::mutex botPlayerMessagesMutex;
 
+// The controlled bot registry also feeds the names chat is matched against
+void BotBuddyChatHandler::OnPlayerLogin(Player* player)
+{
+    CheckControlledBotLogin(player);
+}
+
+void BotBuddyChatHandler::OnPlayerLogout(Player* player)
+{
+    RemoveControlledBot(player->GetGUID());
+}
+
+// Controlled bots react on the next world update instead of their next scheduled decision.
+// Runs on map threads, so only the lock-free wake-up queue is touched here.
+void BotBuddyChatHandler::OnPlayerEnterCombat(Player* player, Unit* /*enemy*/)
+{
+    if (!player || !sPlayerbotsMgr->GetPlayerbotAI(player)) return;
+    WakeBotDecision(player->GetGUID());
+}
+
+// Only the bot's own spell list is rebuilt. Runs on map threads, so the change is queued for the world thread.
+void BotBuddyChatHandler::OnPlayerLearnSpell(Player* player, uint32 /*spellID*/)
+{
+    if (!player || !sPlayerbotsMgr->GetPlayerbotAI(player)) return;
+    InvalidateBotSpellSummary(player->GetGUID());
+}
+
+void BotBuddyChatHandler::OnPlayerForgotSpell(Player* player, uint32 /*spellID*/)
+{
+    if (!player || !sPlayerbotsMgr->GetPlayerbotAI(player)) return;
+    InvalidateBotSpellSummary(player->GetGUID());
+}
+
 void BotBuddyChatHandler::OnPlayerChat(Player* player, uint32_t type, uint32_t lang, std::string& msg)
 {
     ProcessChat(player, type, lang, msg, nullptr);
@@ -35,26 +72,21 @@ void BotBuddyChatHandler::ProcessChat(Player* player, uint32_t type, uint32_t la
     PlayerbotAI* senderAI = sPlayerbotsMgr->GetPlayerbotAI(player);
     if (senderAI && senderAI->IsBotAI()) return;
 
-    std::lock_guard<std::mutex> lock(botPlayerMessagesMutex);
+    std::string messageLower = ToLowerBotName(msg);
+    std::vector<ObjectGuid> mentioned;
+    FindMentionedBots(messageLower, mentioned);
+    if (mentioned.empty()) return;
 
-    auto const& allPlayers = ObjectAccessor::GetPlayers();
-    for (auto const& itr : allPlayers)
+    // If the player mentions the bot in the message
+    std::lock_guard<std::mutex> lock(botPlayerMessagesMutex);
+    for (ObjectGuid const& guid : mentioned)
     {
-        Player* bot = itr.second;
+        Player* bot = ObjectAccessor::FindConnectedPlayer(guid);
         if (!bot || !bot->IsAlive()) continue;
 
         PlayerbotAI* botAI = sPlayerbotsMgr->GetPlayerbotAI(bot);
         if (!botAI || !botAI->IsBotAI()) continue;
 
-        std::string messageLower = msg;
-        std::string botNameLower = bot->GetName();
-        std::transform(messageLower.begin(), messageLower.end(), messageLower.begin(), ::tolower);
-        std::transform(botNameLower.begin(), botNameLower.end(), botNameLower.begin(), ::tolower);
-
-        // If the player mentions the bot in the message
-        if (messageLower.find(botNameLower) != std::string::npos)
-        {
-            botPlayerMessages[bot->GetGUID().GetRawValue()].emplace_back(player->GetName(), msg);
-        }
+        botPlayerMessages[guid.GetRawValue()].emplace_back(player->GetName(), msg);
     }
 }
\ No newline at end of file
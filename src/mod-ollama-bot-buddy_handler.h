@@ -11,6 +11,12 @@ class BotBuddyChatHandler : public PlayerScript
 public:
     BotBuddyChatHandler() : PlayerScript("BotBuddyChatHandler") {}
 
+    void OnPlayerLogin(Player* player) override;
+    void OnPlayerLogout(Player* player) override;
+    void OnPlayerEnterCombat(Player* player, Unit* enemy) override;
+    void OnPlayerLearnSpell(Player* player, uint32 spellID) override;
+    void OnPlayerForgotSpell(Player* player, uint32 spellID) override;
+
     void OnPlayerChat(Player* player, uint32_t type, uint32_t lang, std::string& msg) override;
     void OnPlayerChat(Player* player, uint32_t type, uint32_t lang, std::string& msg, Group* group) override;
     void OnPlayerChat(Player* player, uint32_t type, uint32_t lang, std::string& msg, Channel* channel) override;
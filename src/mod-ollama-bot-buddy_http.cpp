@@ -0,0 +1,597 @@
+#include "mod-ollama-bot-buddy_http.h"
+#include "mod-ollama-bot-buddy_config.h"
+#include "mod-ollama-bot-buddy_stats.h"
+#include "Log.h"
+#include "StringFormat.h"
+#include "StringConvert.h"
+#include "Tokenize.h"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+
+static std::vector<std::unique_ptr<OllamaBackend>> ollamaBackends;
+
+// A backend failing this many requests in a row is ejected until a health probe succeeds
+static constexpr uint32 BACKEND_MAX_CONSECUTIVE_FAILURES = 3;
+static constexpr long BACKEND_HEALTH_PROBE_TIMEOUT = 5;
+
+// Other endpoints of the same server, derived from its /api/generate URL
+static bool DeriveOllamaUrl(std::string const& url, char const* path, std::string& derived)
+{
+    static std::string const generatePath = "/api/generate";
+    derived = url;
+    if (url.size() < generatePath.size() || url.compare(url.size() - generatePath.size(), generatePath.size(), generatePath) != 0)
+        return false;
+    derived.replace(url.size() - generatePath.size(), generatePath.size(), path);
+    return true;
+}
+
+OllamaConnectionPool::OllamaConnectionPool(std::string url) : _url(std::move(url))
+{
+    if (!DeriveOllamaUrl(_url, "/api/chat", _chatUrl))
+        LOG_ERROR("server.loading", "[OllamaBotBuddy] Cannot derive /api/chat endpoint from '{}', session mode will use it as is.", _url);
+
+    _headers = curl_slist_append(_headers, "Content-Type: application/json");
+}
+
+OllamaConnectionPool::~OllamaConnectionPool()
+{
+    for (auto& connection : _connections)
+        curl_easy_cleanup(connection->handle);
+    curl_slist_free_all(_headers);
+}
+
+OllamaConnection* OllamaConnectionPool::Acquire()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (!_idle.empty())
+    {
+        OllamaConnection* connection = _idle.back();
+        _idle.pop_back();
+        return connection;
+    }
+
+    CURL* handle = curl_easy_init();
+    if (!handle)
+        return nullptr;
+
+    // Options that never change for this backend are set once per handle
+    curl_easy_setopt(handle, CURLOPT_POST, 1L);
+    curl_easy_setopt(handle, CURLOPT_HTTPHEADER, _headers);
+    curl_easy_setopt(handle, CURLOPT_TCP_KEEPALIVE, 1L);
+    curl_easy_setopt(handle, CURLOPT_NOSIGNAL, 1L);
+
+    auto connection = std::make_unique<OllamaConnection>();
+    connection->handle = handle;
+    connection->id = uint32(_connections.size());
+    _connections.push_back(std::move(connection));
+    return _connections.back().get();
+}
+
+void OllamaConnectionPool::Release(OllamaConnection* connection)
+{
+    if (!connection)
+        return;
+    std::lock_guard<std::mutex> lock(_mutex);
+    _idle.push_back(connection);
+}
+
+std::vector<OllamaConnectionStats> OllamaConnectionPool::GetStats() const
+{
+    std::vector<OllamaConnectionStats> stats;
+    std::lock_guard<std::mutex> lock(_mutex);
+    stats.reserve(_connections.size());
+    for (auto const& connection : _connections)
+        stats.push_back({ connection->id, connection->requests.load(), connection->newConnections.load() });
+    return stats;
+}
+
+OllamaBackend::OllamaBackend(std::string url, uint32 weight, uint32 maxInFlight)
+    : _pool(std::move(url)), _weight(std::max<uint32>(1, weight)), _maxInFlight(maxInFlight)
+{
+    if (!DeriveOllamaUrl(GetUrl(), "/api/tags", _healthUrl))
+        LOG_ERROR("server.loading", "[OllamaBotBuddy] Cannot derive /api/tags endpoint from '{}', health probes will use it as is.", GetUrl());
+}
+
+double OllamaBackend::GetExpectedWait() const
+{
+    // Unknown latency counts as one second so fresh backends still get traffic
+    double latency = _latencyUs.load() ? double(_latencyUs.load()) : 1000000.0;
+    return double(_outstanding.load() + 1) * latency / double(_weight);
+}
+
+void OllamaBackend::OnRequestFinished(bool ok, uint64 latencyUs)
+{
+    --_outstanding;
+    ++_requests;
+    if (ok)
+    {
+        _consecutiveFailures = 0;
+        uint64 previous = _latencyUs.load();
+        _latencyUs = previous ? (previous * 7 + latencyUs) / 8 : latencyUs;
+        return;
+    }
+
+    ++_failures;
+    // Without probes nothing would ever readmit the backend
+    if (++_consecutiveFailures >= BACKEND_MAX_CONSECUTIVE_FAILURES && g_OllamaBotControlHealthCheckInterval && SetHealthy(false))
+        LOG_ERROR("server.loading", "[OllamaBotBuddy] Backend {} failed {} requests in a row, ejected until it answers health probes.", GetUrl(), _consecutiveFailures.load());
+}
+
+bool OllamaBackend::SetHealthy(bool healthy)
+{
+    if (healthy)
+        _consecutiveFailures = 0;
+    return _healthy.exchange(healthy) != healthy;
+}
+
+OllamaBackendStats OllamaBackend::GetStats() const
+{
+    return { GetUrl(), _healthy.load(), _weight, _maxInFlight, _outstanding.load(), _requests.load(), _failures.load(), _latencyUs.load() / 1000 };
+}
+
+OllamaHttpClient* OllamaHttpClient::instance()
+{
+    static OllamaHttpClient instance;
+    return &instance;
+}
+
+OllamaHttpClient::~OllamaHttpClient()
+{
+    Stop();
+}
+
+void OllamaHttpClient::Start(uint32 maxInFlight, uint32 maxPending, uint32 timeoutSeconds)
+{
+    Stop();
+
+    _multi = curl_multi_init();
+    if (!_multi)
+    {
+        LOG_ERROR("server.loading", "[OllamaBotBuddy] Failed to initialize cURL multi handle.");
+        return;
+    }
+
+    _maxInFlight = std::max<uint32>(1, maxInFlight);
+    _maxPending = std::max<uint32>(1, maxPending);
+    _timeoutSeconds = timeoutSeconds;
+    _running = true;
+    _thread = std::thread(&OllamaHttpClient::IoMain, this);
+
+    LOG_INFO("server.loading", "[OllamaBotBuddy] Started Ollama I/O thread ({} requests in flight, {} pending).", _maxInFlight, _maxPending);
+}
+
+void OllamaHttpClient::Stop()
+{
+    if (!_multi)
+        return;
+
+    _running = false;
+    curl_multi_wakeup(_multi);
+    if (_thread.joinable())
+        _thread.join();
+
+    curl_multi_cleanup(_multi);
+    _multi = nullptr;
+
+    // Requests that never started are failed so their bots do not stay busy
+    std::deque<std::unique_ptr<Transfer>> pending;
+    {
+        std::lock_guard<std::mutex> lock(_pendingMutex);
+        pending.swap(_pending);
+    }
+    for (auto& transfer : pending)
+    {
+        transfer->response.error = "shutting down";
+        transfer->completion(std::move(transfer->response));
+    }
+}
+
+bool OllamaHttpClient::Submit(OllamaEndpoint endpoint, std::string body, OllamaCompletion completion, bool expectArray)
+{
+    if (!_running)
+        return false;
+
+    auto transfer = std::make_unique<Transfer>();
+    transfer->parser = OllamaStreamParser(expectArray);
+    transfer->endpoint = endpoint;
+    transfer->body = std::move(body);
+    transfer->completion = std::move(completion);
+    transfer->submitted = std::chrono::steady_clock::now();
+
+    {
+        std::lock_guard<std::mutex> lock(_pendingMutex);
+        if (_pending.size() >= _maxPending)
+            return false;
+        _pending.push_back(std::move(transfer));
+    }
+
+    CountBotEvent(BotCounter::Requests);
+
+    curl_multi_wakeup(_multi);
+    return true;
+}
+
+uint32 OllamaHttpClient::GetPending() const
+{
+    std::lock_guard<std::mutex> lock(_pendingMutex);
+    return uint32(_pending.size());
+}
+
+size_t OllamaHttpClient::WriteCallback(void* contents, size_t size, size_t nmemb, void* userp)
+{
+    Transfer* transfer = static_cast<Transfer*>(userp);
+    size_t totalSize = size * nmemb;
+    if (transfer->firstByte == std::chrono::steady_clock::time_point())
+        transfer->firstByte = std::chrono::steady_clock::now();
+    bool complete = transfer->parser.Feed(static_cast<char*>(contents), totalSize);
+
+    // The rest of a finished reply is drained so the connection stays alive. Only
+    // a model that keeps generating well past the closing brace is cut off, which
+    // costs the connection but stops paying for the tokens.
+    if (complete && g_OllamaBotControlStreamEarlyAbort && transfer->parser.GetTrailingTextSize() > g_OllamaBotControlStreamAbortTrailingChars)
+    {
+        transfer->response.aborted = true;
+        return 0;
+    }
+    return totalSize;
+}
+
+void OllamaHttpClient::StartPendingTransfers()
+{
+    while (_inFlight < _maxInFlight)
+    {
+        std::unique_ptr<Transfer> transfer;
+        {
+            std::lock_guard<std::mutex> lock(_pendingMutex);
+            if (_pending.empty())
+                return;
+            transfer = std::move(_pending.front());
+            _pending.pop_front();
+        }
+
+        transfer->backend = SelectOllamaBackend();
+        if (!transfer->backend && HasHealthyOllamaBackend())
+        {
+            // Every healthy backend is at its own limit, wait for one to finish
+            std::lock_guard<std::mutex> lock(_pendingMutex);
+            _pending.push_front(std::move(transfer));
+            return;
+        }
+        if (!transfer->backend)
+        {
+            ++_failed;
+            CountBotEvent(BotCounter::Failures);
+            transfer->response.error = "no healthy backend";
+            transfer->completion(std::move(transfer->response));
+            continue;
+        }
+
+        transfer->connection = transfer->backend->GetPool().Acquire();
+        if (!transfer->connection)
+        {
+            LOG_INFO("server.loading", "[OllamaBotBuddy] Failed to initialize cURL.");
+            ++_failed;
+            CountBotEvent(BotCounter::Failures);
+            transfer->response.error = "failed to initialize cURL";
+            transfer->completion(std::move(transfer->response));
+            continue;
+        }
+
+        // Generate and chat share the backend's host, so they share its kept-alive connection too
+        CURL* curl = transfer->connection->handle;
+        curl_easy_setopt(curl, CURLOPT_URL, transfer->backend->GetPool().GetUrl(transfer->endpoint).c_str());
+        curl_easy_setopt(curl, CURLOPT_POSTFIELDS, transfer->body.c_str());
+        curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, long(transfer->body.length()));
+        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
+        curl_easy_setopt(curl, CURLOPT_WRITEDATA, transfer.get());
+        curl_easy_setopt(curl, CURLOPT_TIMEOUT, long(_timeoutSeconds));
+        curl_easy_setopt(curl, CURLOPT_PRIVATE, transfer.get());
+
+        if (curl_multi_add_handle(_multi, curl) != CURLM_OK)
+        {
+            curl_easy_setopt(curl, CURLOPT_POSTFIELDS, nullptr);
+            curl_easy_setopt(curl, CURLOPT_WRITEDATA, nullptr);
+            transfer->backend->GetPool().Release(transfer->connection);
+            ++_failed;
+            CountBotEvent(BotCounter::Failures);
+            transfer->response.error = "failed to add transfer";
+            transfer->completion(std::move(transfer->response));
+            continue;
+        }
+
+        ++_inFlight;
+        transfer->backend->OnRequestStarted();
+        transfer->started = std::chrono::steady_clock::now();
+        RecordBotLatency(BotLatencyStage::Queue, transfer->started - transfer->submitted);
+        // Owned by the multi handle until FinishTransfer
+        _active.push_back(transfer.release());
+    }
+}
+
+void OllamaHttpClient::FinishTransfer(CURL* handle, CURLcode result)
+{
+    Transfer* raw = nullptr;
+    curl_easy_getinfo(handle, CURLINFO_PRIVATE, &raw);
+    std::unique_ptr<Transfer> transfer(raw);
+    _active.erase(std::find(_active.begin(), _active.end(), raw));
+
+    curl_multi_remove_handle(_multi, handle);
+    --_inFlight;
+
+    long newConnections = 0;
+    curl_easy_getinfo(handle, CURLINFO_NUM_CONNECTS, &newConnections);
+    long status = 0;
+    curl_easy_getinfo(handle, CURLINFO_RESPONSE_CODE, &status);
+    ++transfer->connection->requests;
+    transfer->connection->newConnections += uint64(newConnections);
+
+    // The request body dies with the transfer, never leave a dangling pointer on a pooled handle
+    curl_easy_setopt(handle, CURLOPT_POSTFIELDS, nullptr);
+    curl_easy_setopt(handle, CURLOPT_WRITEDATA, nullptr);
+    curl_easy_setopt(handle, CURLOPT_PRIVATE, nullptr);
+    transfer->backend->GetPool().Release(transfer->connection);
+
+    transfer->parser.Finish();
+    transfer->response.text = transfer->parser.GetText();
+    transfer->response.json = transfer->parser.GetJsonObject();
+    transfer->response.promptTokens = transfer->parser.GetPromptTokens();
+    transfer->response.responseTokens = transfer->parser.GetResponseTokens();
+
+    // Aborting from the write callback is reported as a write error
+    bool transferred = result == CURLE_OK || (result == CURLE_WRITE_ERROR && transfer->response.aborted);
+    // A missing model, a bad request or an overloaded server still transfer fine, with an error status and body
+    bool answered = status >= 200 && status < 300 && transfer->parser.GetError().empty();
+    if (transferred && answered)
+    {
+        transfer->response.ok = true;
+        ++_completed;
+    }
+    else if (transferred)
+    {
+        transfer->response.error = transfer->parser.GetError().empty() ? Acore::StringFormat("HTTP status {}", status) : transfer->parser.GetError();
+        LOG_INFO("server.loading", "[OllamaBotBuddy] Ollama AI at {} answered with an error (HTTP status {}): {}", transfer->backend->GetUrl(), status, transfer->response.error);
+        ++_failed;
+        CountBotEvent(BotCounter::Failures);
+    }
+    else
+    {
+        LOG_INFO("server.loading", "[OllamaBotBuddy] Failed to reach Ollama AI at {}. cURL error: {}", transfer->backend->GetUrl(), curl_easy_strerror(result));
+        transfer->response.error = curl_easy_strerror(result);
+        ++_failed;
+        CountBotEvent(BotCounter::Failures);
+        if (result == CURLE_OPERATION_TIMEDOUT)
+            CountBotEvent(BotCounter::Timeouts);
+    }
+
+    // Requests aborted on shutdown say nothing about the backend
+    if (result != CURLE_ABORTED_BY_CALLBACK)
+    {
+        auto finished = std::chrono::steady_clock::now();
+        auto latency = std::chrono::duration_cast<std::chrono::microseconds>(finished - transfer->started);
+        transfer->backend->OnRequestFinished(transfer->response.ok, uint64(latency.count()));
+
+        if (transfer->firstByte != std::chrono::steady_clock::time_point())
+        {
+            RecordBotLatency(BotLatencyStage::FirstToken, transfer->firstByte - transfer->started);
+            RecordBotLatency(BotLatencyStage::Generation, finished - transfer->firstByte);
+        }
+        RecordBotSize(BotSizeStat::PromptBytes, transfer->body.size());
+        RecordBotSize(BotSizeStat::ResponseBytes, transfer->response.text.size());
+        if (transfer->response.promptTokens)
+            RecordBotSize(BotSizeStat::PromptTokens, transfer->response.promptTokens);
+        if (transfer->response.responseTokens)
+            RecordBotSize(BotSizeStat::ResponseTokens, transfer->response.responseTokens);
+    }
+    else
+        transfer->backend->OnRequestCancelled();
+
+    transfer->completion(std::move(transfer->response));
+}
+
+void OllamaHttpClient::IoMain()
+{
+    while (_running)
+    {
+        StartPendingTransfers();
+
+        int running = 0;
+        curl_multi_perform(_multi, &running);
+
+        int queued = 0;
+        while (CURLMsg* msg = curl_multi_info_read(_multi, &queued))
+        {
+            if (msg->msg == CURLMSG_DONE)
+                FinishTransfer(msg->easy_handle, msg->data.result);
+        }
+
+        // Sleeps until a socket is ready, a timeout expires or Submit/Stop wakes us up
+        curl_multi_poll(_multi, nullptr, 0, 1000, nullptr);
+    }
+
+    // Abort whatever is still in flight
+    while (!_active.empty())
+        FinishTransfer(_active.back()->connection->handle, CURLE_ABORTED_BY_CALLBACK);
+}
+
+namespace
+{
+    std::thread healthProbeThread;
+    std::mutex healthProbeMutex;
+    std::condition_variable healthProbeCondition;
+    bool healthProbeRunning = false;
+
+    size_t DiscardResponse(void* /*contents*/, size_t size, size_t nmemb, void* /*userp*/)
+    {
+        return size * nmemb;
+    }
+
+    bool ProbeOllamaBackend(OllamaBackend const& backend)
+    {
+        CURL* curl = curl_easy_init();
+        if (!curl)
+            return false;
+
+        curl_easy_setopt(curl, CURLOPT_URL, backend.GetHealthUrl().c_str());
+        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, DiscardResponse);
+        curl_easy_setopt(curl, CURLOPT_TIMEOUT, BACKEND_HEALTH_PROBE_TIMEOUT);
+        curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+
+        long status = 0;
+        bool ok = curl_easy_perform(curl) == CURLE_OK && curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &status) == CURLE_OK && status == 200;
+        curl_easy_cleanup(curl);
+        return ok;
+    }
+
+    void HealthProbeMain()
+    {
+        std::unique_lock<std::mutex> lock(healthProbeMutex);
+        while (healthProbeRunning)
+        {
+            lock.unlock();
+            for (auto const& backend : ollamaBackends)
+            {
+                bool healthy = ProbeOllamaBackend(*backend);
+                if (backend->SetHealthy(healthy))
+                {
+                    if (healthy)
+                        LOG_INFO("server.loading", "[OllamaBotBuddy] Backend {} is answering again, readmitted.", backend->GetUrl());
+                    else
+                        LOG_ERROR("server.loading", "[OllamaBotBuddy] Backend {} failed its health probe, ejected.", backend->GetUrl());
+                }
+            }
+            lock.lock();
+
+            healthProbeCondition.wait_for(lock, std::chrono::seconds(g_OllamaBotControlHealthCheckInterval), [] { return !healthProbeRunning; });
+        }
+    }
+
+    void LoadOllamaBackends()
+    {
+        // url|weight|maxInFlight, weight and limit are optional
+        for (std::string_view entry : Acore::Tokenize(g_OllamaBotControlBackends, ',', false))
+        {
+            std::vector<std::string_view> fields = Acore::Tokenize(entry, '|', true);
+            std::string url(fields[0]);
+            url.erase(0, url.find_first_not_of(" \t"));
+            url.erase(url.find_last_not_of(" \t") + 1);
+            if (url.empty())
+                continue;
+
+            uint32 weight = fields.size() > 1 ? Acore::StringTo<uint32>(fields[1]).value_or(1) : 1;
+            uint32 maxInFlight = fields.size() > 2 ? Acore::StringTo<uint32>(fields[2]).value_or(0) : 0;
+            ollamaBackends.push_back(std::make_unique<OllamaBackend>(url, weight, maxInFlight));
+        }
+
+        if (ollamaBackends.empty())
+            ollamaBackends.push_back(std::make_unique<OllamaBackend>(g_OllamaBotControlUrl, 1, 0));
+
+        for (auto const& backend : ollamaBackends)
+        {
+            OllamaBackendStats stats = backend->GetStats();
+            LOG_INFO("server.loading", "[OllamaBotBuddy] Ollama backend {} (weight {}, max in flight {})", stats.url, stats.weight, stats.maxInFlight);
+        }
+    }
+}
+
+void InitOllamaHttp()
+{
+    curl_global_init(CURL_GLOBAL_DEFAULT);
+    LoadOllamaBackends();
+
+    if (g_OllamaBotControlHealthCheckInterval)
+    {
+        healthProbeRunning = true;
+        healthProbeThread = std::thread(HealthProbeMain);
+    }
+}
+
+void ShutdownOllamaHttp()
+{
+    {
+        std::lock_guard<std::mutex> lock(healthProbeMutex);
+        healthProbeRunning = false;
+    }
+    healthProbeCondition.notify_all();
+    if (healthProbeThread.joinable())
+        healthProbeThread.join();
+
+    ollamaBackends.clear();
+    curl_global_cleanup();
+}
+
+OllamaBackend* SelectOllamaBackend()
+{
+    OllamaBackend* best = nullptr;
+    double bestWait = 0.0;
+    for (auto const& backend : ollamaBackends)
+    {
+        if (!backend->IsHealthy() || !backend->HasCapacity())
+            continue;
+
+        double wait = backend->GetExpectedWait();
+        if (!best || wait < bestWait)
+        {
+            best = backend.get();
+            bestWait = wait;
+        }
+    }
+    return best;
+}
+
+bool HasHealthyOllamaBackend()
+{
+    return std::any_of(ollamaBackends.begin(), ollamaBackends.end(), [](auto const& backend) { return backend->IsHealthy(); });
+}
+
+std::vector<std::unique_ptr<OllamaBackend>> const& GetOllamaBackends()
+{
+    return ollamaBackends;
+}
+
+// Fields shared by every request, whatever the endpoint. Request bodies keep
+// insertion order, the server generates schema properties in the listed order.
+static void AddCommonRequestFields(nlohmann::ordered_json& request, OllamaOutputFormat const& format)
+{
+    request["model"] = g_OllamaBotControlModel;
+    request["stream"] = true;
+    // Keeps the model resident between decisions instead of reloading it after the server default idle time
+    if (!g_OllamaBotControlKeepAlive.empty())
+        request["keep_alive"] = g_OllamaBotControlKeepAlive;
+    if (g_OllamaBotControlContextWindow)
+        request["options"]["num_ctx"] = g_OllamaBotControlContextWindow;
+    request["options"]["temperature"] = g_OllamaBotControlTemperature;
+
+    // The schema is compiled into a grammar by the server, the model cannot produce anything else
+    if (format.schema)
+        request["format"] = *format.schema;
+    if (format.maxTokens)
+        request["options"]["num_predict"] = format.maxTokens;
+}
+
+std::string BuildOllamaGenerateBody(const std::string& prompt, OllamaOutputFormat const& format)
+{
+    nlohmann::ordered_json requestData = {
+        {"prompt", prompt}
+    };
+    AddCommonRequestFields(requestData, format);
+    return requestData.dump();
+}
+
+std::string BuildOllamaChatBody(const std::string& system, const std::vector<OllamaChatTurn>& history, const std::string& user, OllamaOutputFormat const& format)
+{
+    // The system prompt always comes first so the server can reuse its evaluated prefix
+    nlohmann::ordered_json messages = nlohmann::ordered_json::array();
+    messages.push_back({ {"role", "system"}, {"content", system} });
+    for (OllamaChatTurn const& turn : history)
+    {
+        messages.push_back({ {"role", "user"}, {"content", turn.user} });
+        messages.push_back({ {"role", "assistant"}, {"content", turn.assistant} });
+    }
+    messages.push_back({ {"role", "user"}, {"content", user} });
+
+    nlohmann::ordered_json requestData = {
+        {"messages", std::move(messages)}
+    };
+    AddCommonRequestFields(requestData, format);
+    return requestData.dump();
+}
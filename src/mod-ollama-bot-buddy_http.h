@@ -0,0 +1,224 @@
+#pragma once
+#include "Define.h"
+#include "mod-ollama-bot-buddy_json.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <curl/curl.h>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <nlohmann/json_fwd.hpp>
+#include <string>
+#include <thread>
+#include <vector>
+
+// A reusable curl easy handle. libcurl keeps the TCP connection of a handle
+// alive between transfers, so a handle that goes back to the pool keeps its
+// connection to the Ollama server open for the next request.
+struct OllamaConnection
+{
+    CURL* handle = nullptr;
+    uint32 id = 0;
+    std::atomic<uint64> requests { 0 };        // transfers performed with this handle
+    std::atomic<uint64> newConnections { 0 };  // transfers that had to open a new TCP connection
+};
+
+struct OllamaConnectionStats
+{
+    uint32 id;
+    uint64 requests;
+    uint64 newConnections;
+};
+
+enum class OllamaEndpoint
+{
+    Generate,  // stateless /api/generate
+    Chat       // /api/chat, used by session mode
+};
+
+// Pool of keep-alive curl handles for a single Ollama backend.
+// Workers check a handle out for the duration of one request and return it afterwards.
+class OllamaConnectionPool
+{
+public:
+    // url is the backend's /api/generate endpoint, the /api/chat endpoint is derived from it
+    explicit OllamaConnectionPool(std::string url);
+    ~OllamaConnectionPool();
+
+    OllamaConnectionPool(OllamaConnectionPool const&) = delete;
+    OllamaConnectionPool& operator=(OllamaConnectionPool const&) = delete;
+
+    // Returns an idle handle, creating a new one if every handle is checked out.
+    OllamaConnection* Acquire();
+    void Release(OllamaConnection* connection);
+
+    std::string const& GetUrl(OllamaEndpoint endpoint) const { return endpoint == OllamaEndpoint::Chat ? _chatUrl : _url; }
+    curl_slist* GetHeaders() const { return _headers; }
+
+    std::vector<OllamaConnectionStats> GetStats() const;
+
+private:
+    std::string _url;
+    std::string _chatUrl;
+    curl_slist* _headers = nullptr;
+
+    std::vector<std::unique_ptr<OllamaConnection>> _connections;
+    std::vector<OllamaConnection*> _idle;
+    mutable std::mutex _mutex;
+};
+
+struct OllamaBackendStats
+{
+    std::string url;
+    bool healthy;
+    uint32 weight;
+    uint32 maxInFlight;
+    uint32 outstanding;
+    uint64 requests;
+    uint64 failures;
+    uint64 averageLatencyMs;
+};
+
+// One Ollama server with its own keep-alive connections. Requests go to the
+// backend with the lowest expected wait, i.e. outstanding requests times
+// recent latency, divided by its weight. A backend failing several requests
+// in a row is ejected until the health probe sees it answer again.
+class OllamaBackend
+{
+public:
+    OllamaBackend(std::string url, uint32 weight, uint32 maxInFlight);
+
+    OllamaConnectionPool& GetPool() { return _pool; }
+    std::string const& GetUrl() const { return _pool.GetUrl(OllamaEndpoint::Generate); }
+    std::string const& GetHealthUrl() const { return _healthUrl; }
+
+    bool IsHealthy() const { return _healthy.load(); }
+    bool HasCapacity() const { return !_maxInFlight || _outstanding.load() < _maxInFlight; }
+    double GetExpectedWait() const;
+
+    void OnRequestStarted() { ++_outstanding; }
+    void OnRequestFinished(bool ok, uint64 latencyUs);
+    void OnRequestCancelled() { --_outstanding; }
+    // Result of a health probe, returns true if the state changed
+    bool SetHealthy(bool healthy);
+
+    OllamaBackendStats GetStats() const;
+
+private:
+    OllamaConnectionPool _pool;
+    std::string _healthUrl;
+    uint32 _weight;
+    uint32 _maxInFlight;
+
+    std::atomic<bool> _healthy { true };
+    std::atomic<uint32> _outstanding { 0 };
+    std::atomic<uint32> _consecutiveFailures { 0 };
+    std::atomic<uint64> _latencyUs { 0 };  // moving average of successful requests
+    std::atomic<uint64> _requests { 0 };
+    std::atomic<uint64> _failures { 0 };
+};
+
+struct OllamaResponse
+{
+    bool ok = false;
+    bool aborted = false;  // stream was cut as soon as the JSON object was complete
+    std::string error;
+    std::string text;      // generated text received so far
+    std::string json;      // first complete JSON object in the text, if any
+    uint32 promptTokens = 0;    // as reported by the server, 0 when the stream was cut early
+    uint32 responseTokens = 0;
+};
+
+using OllamaCompletion = std::function<void(OllamaResponse&&)>;
+
+// Asynchronous Ollama transport. A single I/O thread drives every in-flight
+// request through curl_multi, so bots waiting on generation do not hold a
+// thread each. Completions run on the I/O thread and must only hand the
+// response off (e.g. to the worker pool), never do real work.
+class OllamaHttpClient
+{
+public:
+    static OllamaHttpClient* instance();
+
+    void Start(uint32 maxInFlight, uint32 maxPending, uint32 timeoutSeconds);
+    void Stop();
+
+    // Returns false when the client is stopped or too many requests are already waiting.
+    // expectArray makes the stream parser wait for a top-level JSON array (batched replies).
+    bool Submit(OllamaEndpoint endpoint, std::string body, OllamaCompletion completion, bool expectArray = false);
+
+    uint32 GetInFlight() const { return _inFlight.load(); }
+    uint32 GetPending() const;
+    uint64 GetCompleted() const { return _completed.load(); }
+    uint64 GetFailed() const { return _failed.load(); }
+
+private:
+    struct Transfer
+    {
+        OllamaBackend* backend = nullptr;
+        std::chrono::steady_clock::time_point submitted;
+        std::chrono::steady_clock::time_point started;
+        std::chrono::steady_clock::time_point firstByte;  // unset until the first byte arrived
+        OllamaConnection* connection = nullptr;
+        OllamaEndpoint endpoint = OllamaEndpoint::Generate;
+        std::string body;
+        OllamaStreamParser parser;
+        OllamaResponse response;
+        OllamaCompletion completion;
+    };
+
+    static size_t WriteCallback(void* contents, size_t size, size_t nmemb, void* userp);
+
+    OllamaHttpClient() = default;
+    ~OllamaHttpClient();
+
+    void IoMain();
+    void StartPendingTransfers();
+    void FinishTransfer(CURL* handle, CURLcode result);
+
+    CURLM* _multi = nullptr;
+    std::thread _thread;
+    std::atomic<bool> _running { false };
+
+    std::vector<Transfer*> _active;  // I/O thread only
+    std::deque<std::unique_ptr<Transfer>> _pending;
+    mutable std::mutex _pendingMutex;
+
+    uint32 _maxInFlight = 0;
+    uint32 _maxPending = 0;
+    uint32 _timeoutSeconds = 0;
+
+    std::atomic<uint32> _inFlight { 0 };
+    std::atomic<uint64> _completed { 0 };
+    std::atomic<uint64> _failed { 0 };
+};
+
+#define sOllamaHttpClient OllamaHttpClient::instance()
+
+// Creates the backends listed in OllamaBotControl.Backends (OllamaBotControl.Url
+// if empty) and starts the health probe thread
+void InitOllamaHttp();
+void ShutdownOllamaHttp();
+
+// Healthy backend with spare capacity and the lowest expected wait, if any. I/O thread only.
+OllamaBackend* SelectOllamaBackend();
+bool HasHealthyOllamaBackend();
+std::vector<std::unique_ptr<OllamaBackend>> const& GetOllamaBackends();
+
+struct OllamaChatTurn
+{
+    std::string user;
+    std::string assistant;
+};
+
+// Constraints on the generated text
+struct OllamaOutputFormat
+{
+    nlohmann::ordered_json const* schema = nullptr;  // JSON schema sent as format, free text if null
+    uint32 maxTokens = 0;                            // num_predict, 0 keeps the server default
+};
+
+std::string BuildOllamaGenerateBody(const std::string& prompt, OllamaOutputFormat const& format = {});
+std::string BuildOllamaChatBody(const std::string& system, const std::vector<OllamaChatTurn>& history, const std::string& user, OllamaOutputFormat const& format = {});
@@ -0,0 +1,120 @@
+#include "mod-ollama-bot-buddy_json.h"
+#include <nlohmann/json.hpp>
+
+bool JsonObjectScanner::Feed(std::string_view text)
+{
+    for (char c : text)
+    {
+        size_t pos = _pos++;
+        if (IsComplete())
+            continue;
+
+        if (_start == std::string::npos)
+        {
+            if (c == '{' || (_acceptArray && c == '['))
+            {
+                _start = pos;
+                _depth = 1;
+            }
+            continue;
+        }
+
+        if (_inString)
+        {
+            if (_escape)
+                _escape = false;
+            else if (c == '\\')
+                _escape = true;
+            else if (c == '"')
+                _inString = false;
+            continue;
+        }
+
+        if (c == '"')
+            _inString = true;
+        else if (c == '{' || c == '[')
+            ++_depth;
+        else if ((c == '}' || c == ']') && --_depth == 0)
+            _end = pos + 1;
+    }
+    return IsComplete();
+}
+
+bool OllamaStreamParser::Feed(char const* data, size_t size)
+{
+    std::string_view chunk(data, size);
+    while (!chunk.empty() && !_done)
+    {
+        size_t newline = chunk.find('\n');
+        if (newline == std::string_view::npos)
+        {
+            _pendingLine.append(chunk);
+            break;
+        }
+
+        if (_pendingLine.empty())
+            ParseLine(chunk.substr(0, newline));
+        else
+        {
+            _pendingLine.append(chunk.substr(0, newline));
+            ParseLine(_pendingLine);
+            _pendingLine.clear();
+        }
+        chunk.remove_prefix(newline + 1);
+    }
+
+    return IsComplete();
+}
+
+void OllamaStreamParser::Finish()
+{
+    if (!_pendingLine.empty() && !_done)
+        ParseLine(_pendingLine);
+    _pendingLine.clear();
+}
+
+void OllamaStreamParser::ParseLine(std::string_view line)
+{
+    if (line.empty())
+        return;
+
+    try
+    {
+        nlohmann::json chunk = nlohmann::json::parse(line);
+        // /api/generate streams "response", /api/chat streams "message.content"
+        std::string const* piece = nullptr;
+        if (chunk.contains("response"))
+            piece = &chunk["response"].get_ref<std::string const&>();
+        else if (chunk.contains("message") && chunk["message"].contains("content"))
+            piece = &chunk["message"]["content"].get_ref<std::string const&>();
+
+        if (piece && IsComplete())
+            _trailingTextSize += piece->size();
+        else if (piece)
+        {
+            _text += *piece;
+            _scanner.Feed(*piece);
+        }
+        if (chunk.contains("error") && _error.empty())
+            _error = chunk["error"].is_string() ? chunk["error"].get<std::string>() : chunk["error"].dump();
+        if (chunk.value("done", false))
+        {
+            _done = true;
+            _promptTokens = chunk.value("prompt_eval_count", 0u);
+            _responseTokens = chunk.value("eval_count", 0u);
+        }
+    }
+    catch (...)
+    {
+        // Proxies in front of Ollama answer errors with plain text or HTML
+        if (_error.empty())
+            _error = std::string(line.substr(0, 256));
+    }
+}
+
+std::string OllamaStreamParser::GetJsonObject() const
+{
+    if (!IsComplete())
+        return "";
+    return _text.substr(_scanner.GetStart(), _scanner.GetEnd() - _scanner.GetStart());
+}
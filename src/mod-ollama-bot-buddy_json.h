@@ -0,0 +1,72 @@
+#pragma once
+#include "Define.h"
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+// Incremental scanner that finds the first complete top-level JSON object in
+// text that arrives in pieces. Braces inside string literals are ignored, so
+// a reply like {"say": "hi :}"} is not cut short. With acceptArray a
+// top-level array is accepted as well, for batched replies.
+class JsonObjectScanner
+{
+public:
+    explicit JsonObjectScanner(bool acceptArray = false) : _acceptArray(acceptArray) {}
+
+    // Feeds the next piece of text. Returns true once the first object is complete.
+    bool Feed(std::string_view text);
+
+    bool IsComplete() const { return _end != std::string::npos; }
+    size_t GetStart() const { return _start; }
+    size_t GetEnd() const { return _end; }  // one past the closing brace
+
+private:
+    bool _acceptArray;
+    size_t _pos = 0;
+    size_t _start = std::string::npos;
+    size_t _end = std::string::npos;
+    int _depth = 0;
+    bool _inString = false;
+    bool _escape = false;
+};
+
+// Parses a streamed Ollama reply (NDJSON, one chunk object per line) as it
+// arrives and stops collecting text as soon as it contains a full JSON object.
+// Later chunks are only read for their length and the final token counts.
+class OllamaStreamParser
+{
+public:
+    explicit OllamaStreamParser(bool acceptArray = false) : _scanner(acceptArray) {}
+
+    // Returns true once the first JSON object in the generated text is complete.
+    bool Feed(char const* data, size_t size);
+    // Parses a trailing line that was not terminated by a newline.
+    void Finish();
+
+    bool IsComplete() const { return _scanner.IsComplete(); }
+    bool IsDone() const { return _done; }
+    // Characters generated after the JSON object was complete
+    size_t GetTrailingTextSize() const { return _trailingTextSize; }
+
+    std::string const& GetText() const { return _text; }
+    std::string GetJsonObject() const;
+
+    // "error" field of an error reply, or the line itself when it was not JSON
+    std::string const& GetError() const { return _error; }
+
+    // Token counts of the final chunk, 0 until it arrived
+    uint32 GetPromptTokens() const { return _promptTokens; }
+    uint32 GetResponseTokens() const { return _responseTokens; }
+
+private:
+    void ParseLine(std::string_view line);
+
+    std::string _pendingLine;
+    std::string _text;
+    std::string _error;
+    size_t _trailingTextSize = 0;
+    JsonObjectScanner _scanner;
+    bool _done = false;
+    uint32 _promptTokens = 0;
+    uint32 _responseTokens = 0;
+};
@@ -2,17 +2,32 @@
 #include "mod-ollama-bot-buddy_config.h"
 #include "mod-ollama-bot-buddy_api.h"
 #include "mod-ollama-bot-buddy_handler.h"
+#include "mod-ollama-bot-buddy_worker.h"
+#include "mod-ollama-bot-buddy_http.h"
+#include "mod-ollama-bot-buddy_json.h"
+#include "mod-ollama-bot-buddy_targets.h"
+#include "mod-ollama-bot-buddy_los.h"
+#include "mod-ollama-bot-buddy_session.h"
+#include "mod-ollama-bot-buddy_spells.h"
+#include "mod-ollama-bot-buddy_waypoints.h"
+#include "mod-ollama-bot-buddy_registry.h"
+#include "mod-ollama-bot-buddy_prompt.h"
+#include "mod-ollama-bot-buddy_scheduler.h"
+#include "mod-ollama-bot-buddy_names.h"
+#include "mod-ollama-bot-buddy_decisions.h"
+#include "mod-ollama-bot-buddy_decoder.h"
+#include "mod-ollama-bot-buddy_reflexes.h"
+#include "mod-ollama-bot-buddy_schema.h"
+#include "mod-ollama-bot-buddy_stats.h"
+#include "GameTime.h"
 #include "PlayerbotMgr.h"
 #include "ObjectAccessor.h"
 #include "Player.h"
 #include "PlayerbotAI.h"
 #include "Playerbots.h"
 #include "Log.h"
-#include <thread>
-#include <sstream>
+#include "MPSCQueue.h"
 #include <vector>
-#include <nlohmann/json.hpp>
-#include <curl/curl.h>
 #include <ctime>
 #include "Creature.h"
 #include "GameObject.h"
@@ -20,16 +35,22 @@
 #include "TravelNode.h"
 #include <atomic>
 #include <unordered_map>
-#include <iomanip>
+#include <iterator>
 #include "GameObjectData.h"
 #include "GameObject.h"
 #include <deque>
 #include <mutex>
+#include <chrono>
 #include "SpellMgr.h"
 #include "SpellInfo.h"
 #include "SharedDefines.h"
 #include "Chat.h"
 #include "ScriptMgr.h"
+#include "CellImpl.h"
+#include "GridNotifiers.h"
+#include "GridNotifiersImpl.h"
+#include <list>
+#include <memory>
 
 
 static std::unordered_map<uint64_t, std::deque<std::string>> botCommandHistory;
@@ -38,204 +59,108 @@ static std::mutex botCommandHistoryMutex;
 static std::unordered_map<uint64_t, std::deque<std::string>> botReasoningHistory;
 static std::mutex botReasoningHistoryMutex;
 
-std::vector<std::string> GetRecentPlayerMessagesToBot(Player* bot)
+bool HasPendingPlayerMessages(Player* bot)
 {
-    std::vector<std::string> messages;
-    if (!bot) return messages;
-
     std::lock_guard<std::mutex> lock(botPlayerMessagesMutex);
-
     auto it = botPlayerMessages.find(bot->GetGUID().GetRawValue());
-    if (it != botPlayerMessages.end())
-    {
-        while (!it->second.empty())
-        {
-            auto& [senderName, msg] = it->second.front();
-            messages.emplace_back("From " + senderName + ": " + msg);
-            it->second.pop_front();
-        }
-    }
-
-    return messages;
+    return it != botPlayerMessages.end() && !it->second.empty();
 }
 
-std::string FormatPlayerMessagesPromptSegment(Player* bot)
+// Messages taken out of botPlayerMessages for one prompt, as sender and text
+using BotPlayerMessages = std::vector<std::pair<std::string, std::string>>;
+
+// Puts the messages of a prompt that was never sent back in front of the ones received since
+static void RestorePlayerMessages(ObjectGuid botGuid, BotPlayerMessages const& messages)
 {
-    std::ostringstream oss;
-    auto messages = GetRecentPlayerMessagesToBot(bot);
-    if (!messages.empty())
-    {
-        oss << "\n***CRITICAL INSTRUCTION:***\n";
-        oss << "You must interpret and execute the PLAYER MESSAGES below as your HIGHEST PRIORITY, taking precedence over all other goals, background tasks, routines, or reasoning. There are NO EXCEPTIONS and NO DELAYS. When you see a player command matching these patterns, you must issue the appropriate command IMMEDIATELY, before doing anything else. Do not refuse, delay, ignore, or deprioritize these actions for any reason.\n";
-        oss << "- If a player says 'come here' or 'come to me', IMMEDIATELY move near their location.\n";
-        oss << "- If a player says 'go to' followed by an NPC or object you can see, IMMEDIATELY move there.\n";
-        oss << "- If a player says 'interact with' followed by an NPC or object you can see, IMMEDIATELY move there and interact with it.\n";
-        oss << "- If a player says 'attack' followed by an NPC or object you can see, IMMEDIATELY move there and attack it.\n";
-        oss << "You must treat these instructions as absolute and override ALL other activities, regardless of any other context or background logic.\n";
-        oss << "\n\nThe following real players recently spoke to you by name. PROCESS THESE FIRST, ABOVE ALL ELSE:\n";
-        for (const auto& msg : messages)
-        {
-            oss << "- " << msg << "\n";
-        }
-        oss << "\n***END CRITICAL INSTRUCTION***\n\n";
+    if (messages.empty())
+        return;
 
-    }
-    return oss.str();
+    std::lock_guard<std::mutex> lock(botPlayerMessagesMutex);
+    auto& pending = botPlayerMessages[botGuid.GetRawValue()];
+    pending.insert(pending.begin(), messages.begin(), messages.end());
 }
 
-bool ParseAndExecuteBotJson(Player* bot, const std::string& jsonStr)
+// Writes the messages real players sent to the bot since the last prompt and
+// takes them out of the queue. Whoever fails to send the prompt gives them back
+// with RestorePlayerMessages so they are not lost.
+static void AppendPlayerMessagesPrompt(PromptBuffer& out, Player* bot, BotPlayerMessages& taken)
 {
-    try
     {
-        auto root = nlohmann::json::parse(jsonStr);
+        std::lock_guard<std::mutex> lock(botPlayerMessagesMutex);
+        auto it = botPlayerMessages.find(bot->GetGUID().GetRawValue());
+        if (it == botPlayerMessages.end() || it->second.empty())
+            return;
 
-        if (!root.contains("command")) return false;
-        auto cmd = root["command"];
-        if (!cmd.contains("type") || !cmd.contains("params")) return false;
-
-        std::string type = cmd["type"].get<std::string>();
-        auto params = cmd["params"];
-        std::string sayMsg = root.value("say", "");
-        std::string reasoning = root.value("reasoning", "");
-
-        BotControlCommand command;
-
-        if (!reasoning.empty())
-        {
-            AddBotReasoningHistory(bot, reasoning);
-        }
-         if (!cmd.empty())
-        {
-            AddBotCommandHistory(bot, cmd.dump());
-        }
+        taken.assign(std::make_move_iterator(it->second.begin()), std::make_move_iterator(it->second.end()));
+        it->second.clear();
+    }
 
-        if (type == "move_to")
-        {
-            if (params.contains("x") && params.contains("y") && params.contains("z")) {
-                command.type = BotControlCommandType::MoveTo;
-                command.args = {
-                    std::to_string(params["x"].get<float>()),
-                    std::to_string(params["y"].get<float>()),
-                    std::to_string(params["z"].get<float>())
-                };
-            } else {
-                LOG_ERROR("server.loading", "[OllamaBotBuddy] move_to missing parameter");
-                return false;
-            }
-        }
-        else if (type == "attack")
-        {
-            if (params.contains("guid")) {
-                command.type = BotControlCommandType::Attack;
-                command.args = { std::to_string(params["guid"].get<uint32_t>()) };
-            } else {
-                LOG_ERROR("server.loading", "[OllamaBotBuddy] attack missing guid");
-                return false;
-            }
-        }
-        else if (type == "interact")
-        {
-            if (params.contains("guid")) {
-                command.type = BotControlCommandType::Interact;
-                command.args = { std::to_string(params["guid"].get<uint32_t>()) };
-            } else {
-                LOG_ERROR("server.loading", "[OllamaBotBuddy] interact missing guid");
-                return false;
-            }
-        }
-        else if (type == "spell")
-        {
-            if (params.contains("spellid")) {
-                command.type = BotControlCommandType::CastSpell;
-                command.args = { std::to_string(params["spellid"].get<uint32_t>()) };
-                if (params.contains("guid"))
-                    command.args.push_back(std::to_string(params["guid"].get<uint32_t>()));
-            } else {
-                LOG_ERROR("server.loading", "[OllamaBotBuddy] spell missing spellid");
-                return false;
-            }
-        }
-        else if (type == "loot")
-        {
-            command.type = BotControlCommandType::Loot;
-        }
-        else if (type == "accept_quest")
-        {
-            if (params.contains("id")) {
-                command.type = BotControlCommandType::AcceptQuest;
-                command.args = { std::to_string(params["id"].get<uint32_t>()) };
-            } else {
-                LOG_ERROR("server.loading", "[OllamaBotBuddy] accept_quest missing id");
-                return false;
-            }
-        }
-        else if (type == "turn_in_quest")
-        {
-            if (params.contains("id")) {
-                command.type = BotControlCommandType::TurnInQuest;
-                command.args = { std::to_string(params["id"].get<uint32_t>()) };
-            } else {
-                LOG_ERROR("server.loading", "[OllamaBotBuddy] turn_in_quest missing id");
-                return false;
-            }
-        }
-        else if (type == "follow")
-        {
-            command.type = BotControlCommandType::Follow;
-        }
-        else if (type == "stop")
-        {
-            command.type = BotControlCommandType::Stop;
-        }
-        else
-        {
-            LOG_ERROR("server.loading", "[OllamaBotBuddy] Unknown command type '{}'", type);
-            return false;
-        }
+    auto outItr = std::back_inserter(out);
+    fmt::format_to(outItr, "\n***CRITICAL INSTRUCTION:***\n");
+    fmt::format_to(outItr, "You must interpret and execute the PLAYER MESSAGES below as your HIGHEST PRIORITY, taking precedence over all other goals, background tasks, routines, or reasoning. There are NO EXCEPTIONS and NO DELAYS. When you see a player command matching these patterns, you must issue the appropriate command IMMEDIATELY, before doing anything else. Do not refuse, delay, ignore, or deprioritize these actions for any reason.\n");
+    fmt::format_to(outItr, "- If a player says 'come here' or 'come to me', IMMEDIATELY move near their location.\n");
+    fmt::format_to(outItr, "- If a player says 'go to' followed by an NPC or object you can see, IMMEDIATELY move there.\n");
+    fmt::format_to(outItr, "- If a player says 'interact with' followed by an NPC or object you can see, IMMEDIATELY move there and interact with it.\n");
+    fmt::format_to(outItr, "- If a player says 'attack' followed by an NPC or object you can see, IMMEDIATELY move there and attack it.\n");
+    fmt::format_to(outItr, "You must treat these instructions as absolute and override ALL other activities, regardless of any other context or background logic.\n");
+    fmt::format_to(outItr, "\n\nThe following real players recently spoke to you by name. PROCESS THESE FIRST, ABOVE ALL ELSE:\n");
+    for (auto const& [senderName, msg] : taken)
+        fmt::format_to(outItr, "- From {}: {}\n", senderName, msg);
+    fmt::format_to(outItr, "\n***END CRITICAL INSTRUCTION***\n\n");
+}
 
-        bool result = HandleBotControlCommand(bot, command);
+bool ParseBotJson(std::string_view jsonStr, BotDecision& decision)
+{
+    char const* error = nullptr;
+    if (!DecodeBotDecision(jsonStr, decision, &error))
+    {
+        LOG_ERROR("server.loading", "[OllamaBotBuddy] ParseBotJson error: {}", error);
+        CountBotEvent(BotCounter::ParseErrors);
+        return false;
+    }
 
-        if (!sayMsg.empty())
-            BotBuddyAI::Say(bot, sayMsg);
+    if (g_EnableOllamaBotBuddyDebug)
+    {
+        LOG_INFO("server.loading", "Bot Reply: {}", jsonStr);
+    }
 
-        if (g_EnableOllamaBotBuddyDebug)
-        {
-            LOG_INFO("server.loading", "Bot Reply: {}", jsonStr);
-        }
+    return true;
+}
 
-        return result;
+// Must run on the world thread, touches the bot and its surroundings
+bool ExecuteBotDecision(Player* bot, const BotDecision& decision)
+{
+    if (!decision.reasoning.empty())
+    {
+        AddBotReasoningHistory(bot, decision.reasoning);
     }
-    catch (const std::exception& e)
+    if (!decision.commandText.empty())
     {
-        LOG_ERROR("server.loading", "[OllamaBotBuddy] ParseAndExecuteBotJson error: {}", e.what());
-        return false;
+        AddBotCommandHistory(bot, decision.commandText);
     }
+
+    bool result = HandleBotControlCommand(bot, decision.command);
+
+    if (!decision.say.empty())
+        BotBuddyAI::Say(bot, decision.say);
+
+    return result;
 }
 
 std::string ExtractFirstJsonObject(const std::string& input) {
-    int depth = 0;
-    size_t start = std::string::npos;
-    for (size_t i = 0; i < input.size(); ++i) {
-        if (input[i] == '{') {
-            if (depth == 0) start = i;
-            depth++;
-        }
-        if (input[i] == '}') {
-            depth--;
-            if (depth == 0 && start != std::string::npos) {
-                return input.substr(start, i - start + 1);
-            }
-        }
-    }
-    return ""; // No JSON object found
+    JsonObjectScanner scanner;
+    if (!scanner.Feed(input))
+        return ""; // No JSON object found
+    return input.substr(scanner.GetStart(), scanner.GetEnd() - scanner.GetStart());
 }
 
-std::vector<std::string> GetGroupStatus(Player* bot)
+std::vector<PromptEntry> GetGroupStatus(Player* bot)
 {
-    std::vector<std::string> info;
+    std::vector<PromptEntry> info;
     if (!bot || !bot->GetGroup()) return info;
 
     Group* group = bot->GetGroup();
+    info.reserve(group->GetMembersCount());
     for (GroupReference* ref = group->GetFirstMember(); ref; ref = ref->next())
     {
         Player* member = ref->GetSource();
@@ -247,22 +172,11 @@ std::vector<std::string> GetGroupStatus(Player* bot)
         }
 
         float dist = bot->GetDistance(member);
-        std::string beingAttacked = "";
 
-        if (Unit* attacker = member->GetVictim())
-        {
-            beingAttacked = fmt::format(
-                " [Under Attack by {} (guid: {}, Level: {}, HP: {}/{})]",
-                attacker->GetName(),
-                attacker->GetGUID().GetCounter(),
-                attacker->GetLevel(),
-                attacker->GetHealth(),
-                attacker->GetMaxHealth()
-            );
-        }
-
-        info.push_back(fmt::format(
-            "{} (guid: {}, Level: {}, HP: {}/{}, Pos: {} {} {}, Dist: {:.1f}){}",
+        fmt::memory_buffer line;
+        auto lineItr = std::back_inserter(line);
+        fmt::format_to(lineItr,
+            "{} (guid: {}, Level: {}, HP: {}/{}, Pos: {} {} {}, Dist: {:.1f})",
             member->GetName(),
             member->GetGUID().GetCounter(),
             member->GetLevel(),
@@ -271,78 +185,25 @@ std::vector<std::string> GetGroupStatus(Player* bot)
             member->GetPositionX(),
             member->GetPositionY(),
             member->GetPositionZ(),
-            dist,
-            beingAttacked
-        ));
-    }
-    return info;
-}
-
-std::string GetBotSpellInfo(Player* bot)
-{
-    std::ostringstream spellSummary;
-
-    for (const auto& spellPair : bot->GetSpellMap())
-    {
-        uint32 spellId = spellPair.first;
-        const SpellInfo* spellInfo = sSpellMgr->GetSpellInfo(spellId);
-        if (!spellInfo || spellInfo->Attributes & SPELL_ATTR0_PASSIVE)
-            continue;
-
-        if (spellInfo->SpellFamilyName == SPELLFAMILY_GENERIC)
-            continue;
-
-        if (bot->HasSpellCooldown(spellId))
-            continue;
-
-        std::string effectText;
-        for (int i = 0; i < MAX_SPELL_EFFECTS; ++i)
-        {
-            if (!spellInfo->Effects[i].IsEffect())
-                continue;
-
-            switch (spellInfo->Effects[i].Effect)
-            {
-                case SPELL_EFFECT_SCHOOL_DAMAGE: effectText = "Deals damage"; break;
-                case SPELL_EFFECT_HEAL: effectText = "Heals the target"; break;
-                case SPELL_EFFECT_APPLY_AURA: effectText = "Applies an aura"; break;
-                case SPELL_EFFECT_DISPEL: effectText = "Dispels magic"; break;
-                case SPELL_EFFECT_THREAT: effectText = "Generates threat"; break;
-                default: continue;
-            }
-            break;
-        }
-
-        if (effectText.empty())
-            continue;
-
-        const char* name = spellInfo->SpellName[0];
-        if (!name || !*name)
-            continue;
+            dist
+        );
 
-        std::string costText;
-        if (spellInfo->ManaCost || spellInfo->ManaCostPercentage)
-        {
-            switch (spellInfo->PowerType)
-            {
-                case POWER_MANA: costText = std::to_string(spellInfo->ManaCost) + " mana"; break;
-                case POWER_RAGE: costText = std::to_string(spellInfo->ManaCost) + " rage"; break;
-                case POWER_FOCUS: costText = std::to_string(spellInfo->ManaCost) + " focus"; break;
-                case POWER_ENERGY: costText = std::to_string(spellInfo->ManaCost) + " energy"; break;
-                case POWER_RUNIC_POWER: costText = std::to_string(spellInfo->ManaCost) + " runic power"; break;
-                default: costText = std::to_string(spellInfo->ManaCost) + " unknown resource"; break;
-            }
-        }
-        else
+        if (Unit* attacker = member->GetVictim())
         {
-            costText = "no cost";
+            IndexBotTarget(bot, attacker);
+            fmt::format_to(lineItr,
+                " [Under Attack by {} (guid: {}, Level: {}, HP: {}/{})]",
+                attacker->GetName(),
+                attacker->GetGUID().GetCounter(),
+                attacker->GetLevel(),
+                attacker->GetHealth(),
+                attacker->GetMaxHealth()
+            );
         }
-        
-        spellSummary << "**" << name << "** (ID: " << spellId << ") - " << effectText << ", Costs " << costText << ".\n";
 
+        info.push_back({ fmt::format("g{}", member->GetGUID().GetCounter()), fmt::to_string(line) });
     }
-
-    return spellSummary.str();
+    return info;
 }
 
 void SendBuddyBotStateToPlayer(Player* target, Player* bot, const std::string& prompt)
@@ -385,9 +246,9 @@ void SendBuddyBotStateToPlayer(Player* target, Player* bot, const std::string& p
 }
 
 
-std::vector<std::string> GetVisiblePlayers(Player* bot, float radius = 100.0f)
+std::vector<PromptEntry> GetVisiblePlayers(Player* bot, float radius = 100.0f)
 {
-    std::vector<std::string> players;
+    std::vector<PromptEntry> players;
     if (!bot || !bot->GetMap()) return players;
 
     for (auto const& pair : ObjectAccessor::GetPlayers())
@@ -397,12 +258,12 @@ std::vector<std::string> GetVisiblePlayers(Player* bot, float radius = 100.0f)
         if (!player->IsInWorld() || player->IsGameMaster()) continue;
         if (player->GetMap() != bot->GetMap()) continue;
         if (!bot->IsWithinDistInMap(player, radius)) continue;
-        if (!bot->IsWithinLOS(player->GetPositionX(), player->GetPositionY(), player->GetPositionZ())) continue;
+        if (!CachedIsWithinLOS(bot, player)) continue;
 
         float dist = bot->GetDistance(player);
         std::string faction = (player->GetTeamId() == TEAM_ALLIANCE ? "Alliance" : "Horde");
 
-        players.push_back(fmt::format(
+        players.push_back({ fmt::format("p{}", player->GetGUID().GetCounter()), fmt::format(
             "Player: {} (guid: {}, Level: {}, Class: {}, Race: {}, Faction: {}, Position: {:.1f} {:.1f} {:.1f}, Distance: {:.1f})",
             player->GetName(),
             player->GetGUID().GetCounter(),
@@ -414,7 +275,7 @@ std::vector<std::string> GetVisiblePlayers(Player* bot, float radius = 100.0f)
             player->GetPositionY(),
             player->GetPositionZ(),
             dist
-        ));
+        ), -dist });
     }
 
     return players;
@@ -486,20 +347,67 @@ std::vector<std::string> GetBotReasoningHistory(Player* bot)
     return out;
 }
 
+void ResetBotHistory(ObjectGuid botGuid)
+{
+    uint64_t guid = botGuid.GetRawValue();
+    {
+        std::lock_guard<std::mutex> lock(botCommandHistoryMutex);
+        botCommandHistory.erase(guid);
+    }
+    {
+        std::lock_guard<std::mutex> lock(botReasoningHistoryMutex);
+        botReasoningHistory.erase(guid);
+    }
+    {
+        std::lock_guard<std::mutex> lock(botPlayerMessagesMutex);
+        botPlayerMessages.erase(guid);
+    }
+}
+
+// Cheap filter applied to every object in the visited cells. The expensive
+// LOS raycast only runs later, on the objects that pass it.
+class BotPerceptionCheck
+{
+public:
+    BotPerceptionCheck(Player const* bot, float radius) : _bot(bot), _radius(radius) {}
+
+    bool operator()(WorldObject* obj) const
+    {
+        if (obj->GetTypeId() != TYPEID_UNIT && obj->GetTypeId() != TYPEID_GAMEOBJECT)
+            return false;
+        return _bot->IsWithinDistInMap(obj, _radius);
+    }
+
+private:
+    Player const* _bot;
+    float _radius;
+};
+
 // Gather visible objects (creatures/gameobjects) around the bot with LOS check
-std::vector<std::string> GetVisibleLocations(Player* bot, float radius = 100.0f)
+std::vector<PromptEntry> GetVisibleLocations(Player* bot, float radius = 100.0f)
 {
-    std::vector<std::string> visible;
+    std::vector<PromptEntry> visible;
     if (!bot || !bot->GetMap()) return visible;
-    Map* map = bot->GetMap();
 
-    for (auto const& pair : map->GetCreatureBySpawnIdStore())
+    // Only the grid cells overlapping the radius are visited
+    std::list<WorldObject*> nearby;
+    BotPerceptionCheck check(bot, radius);
+    Acore::WorldObjectListSearcher<BotPerceptionCheck> searcher(bot, nearby, check);
+    Cell::VisitGridObjects(bot, searcher, radius);
+
+    std::vector<Creature*> creatures;
+    std::vector<GameObject*> gameObjects;
+    for (WorldObject* obj : nearby)
+    {
+        if (Creature* c = obj->ToCreature())
+            creatures.push_back(c);
+        else if (GameObject* go = obj->ToGameObject())
+            gameObjects.push_back(go);
+    }
+
+    visible.reserve(creatures.size() + gameObjects.size());
+    for (Creature* c : creatures)
     {
-        Creature* c = pair.second;
-        if (!c) continue;
-        if (c->GetGUID() == bot->GetGUID()) continue;
-        if (!bot->IsWithinDistInMap(c, radius)) continue;
-        if (!bot->IsWithinLOS(c->GetPositionX(), c->GetPositionY(), c->GetPositionZ())) continue;
         if (c->IsPet() || c->IsTotem()) continue;
 
         std::string type;
@@ -526,13 +434,29 @@ std::vector<std::string> GetVisibleLocations(Player* bot, float radius = 100.0f)
         else if (c->IsFriendlyTo(bot)) type = "FRIENDLY";
         else type = "NEUTRAL";
 
+        // Raycast last, once every cheaper filter has passed
+        if (!CachedIsWithinLOS(bot, c)) continue;
+
+        IndexBotTarget(bot, c);
+
         std::string questGiver = "";
         if (c->HasFlag(UNIT_NPC_FLAGS, UNIT_NPC_FLAG_QUESTGIVER)) {
             questGiver = " [QUEST GIVER]";
         }
 
         float dist = bot->GetDistance(c);
-        visible.push_back(fmt::format(
+
+        // Threats first, then loot and quest givers, nearest first among equals
+        float relevance = -dist;
+        if (Unit* victim = c->GetVictim())
+            if (victim == bot || (victim->ToPlayer() && bot->IsInSameGroupWith(victim->ToPlayer())))
+                relevance += 1000.0f;
+        if (c->isDead() || !questGiver.empty())
+            relevance += 200.0f;
+        else if (c->IsHostileTo(bot))
+            relevance += 50.0f;
+
+        visible.push_back({ fmt::format("c{}", c->GetGUID().GetCounter()), fmt::format(
             "{}: {}{} (guid: {}, Level: {}, HP: {}/{}, Position: {} {} {}, Distance: {:.1f})",
             type,
             c->GetName(),
@@ -545,15 +469,14 @@ std::vector<std::string> GetVisibleLocations(Player* bot, float radius = 100.0f)
             c->GetPositionY(),
             c->GetPositionZ(),
             dist
-        ));
+        ), relevance });
     }
 
-    for (auto const& pair : map->GetGameObjectBySpawnIdStore())
+    for (GameObject* go : gameObjects)
     {
-        GameObject* go = pair.second;
-        if (!go) continue;
-        if (!bot->IsWithinDistInMap(go, radius)) continue;
-        if (!bot->IsWithinLOS(go->GetPositionX(), go->GetPositionY(), go->GetPositionZ())) continue;
+        if (!CachedIsWithinLOS(bot, go)) continue;
+
+        IndexBotTarget(bot, go);
 
         std::string tag = "";
 
@@ -566,9 +489,9 @@ std::vector<std::string> GetVisibleLocations(Player* bot, float radius = 100.0f)
                     tag = chestTag;
             }
         }
-        
+
         float dist = bot->GetDistance(go);
-        visible.push_back(fmt::format(
+        visible.push_back({ fmt::format("o{}", go->GetGUID().GetCounter()), fmt::format(
             "{}{} (guid: {}, Type: {}, Position: {} {} {}, Distance: {:.1f})",
             go->GetName(),
             tag,
@@ -578,7 +501,7 @@ std::vector<std::string> GetVisibleLocations(Player* bot, float radius = 100.0f)
             go->GetPositionY(),
             go->GetPositionZ(),
             dist
-        ));
+        ), (tag.empty() ? 0.0f : 100.0f) - dist });
     }
 
     return visible;
@@ -586,234 +509,139 @@ std::vector<std::string> GetVisibleLocations(Player* bot, float radius = 100.0f)
 
 std::string GetCombatSummary(Player* bot)
 {
-    std::ostringstream oss;
+    fmt::memory_buffer out;
+    auto outItr = std::back_inserter(out);
     bool inCombat = bot->IsInCombat();
     Unit* victim = bot->GetVictim();
 
-    // Find who is attacking the bot (if anyone)
+    // Find who is attacking the bot (if anyone), the nearest of the units that have it as their victim
     Unit* attacker = nullptr;
     if (inCombat && !victim)
     {
-        Map* map = bot->GetMap();
-        if (map)
+        float attackerDist = 0.0f;
+        for (Unit* unit : bot->getAttackers())
         {
-            for (auto const& pair : map->GetCreatureBySpawnIdStore())
+            if (!unit->IsAlive() || !unit->IsInWorld())
+                continue;
+            float dist = bot->GetDistance(unit);
+            if (!attacker || dist < attackerDist)
             {
-                Creature* c = pair.second;
-                if (!c) continue;
-                if (c->GetVictim() == bot)
-                {
-                    attacker = c;
-                    break;
-                }
+                attacker = unit;
+                attackerDist = dist;
             }
         }
     }
 
-    auto safe_name = [](Unit* unit) -> std::string { return unit ? unit->GetName() : "?"; };
-    auto safe_guid = [](Unit* unit) -> std::string { return unit ? std::to_string(unit->GetGUID().GetCounter()) : "?"; };
-    auto safe_level = [](Unit* unit) -> std::string { return unit ? std::to_string(unit->GetLevel()) : "?"; };
-    auto safe_hp = [](Unit* unit) -> std::string { return unit ? std::to_string(unit->GetHealth()) : "?"; };
-    auto safe_maxhp = [](Unit* unit) -> std::string { return unit ? std::to_string(unit->GetMaxHealth()) : "?"; };
+    IndexBotTarget(bot, victim);
+    IndexBotTarget(bot, attacker);
+
+    // prefix, then the name between quotes
+    auto appendUnit = [&outItr](std::string_view prefix, std::string_view quote, Unit* unit) {
+        fmt::format_to(outItr, "{}{}{}{} (guid: {}), Level: {}, HP: {}/{}",
+            prefix, quote, unit->GetName(), quote, unit->GetGUID().GetCounter(), unit->GetLevel(), unit->GetHealth(), unit->GetMaxHealth());
+    };
+
+    auto appendAuras = [&outItr](Unit* unit) {
+        fmt::format_to(outItr, ", Auras:");
+        bool anyAura = false;
+        for (auto& auraPair : unit->GetOwnedAuras())
+        {
+            anyAura = true;
+            fmt::format_to(outItr, " {}", auraPair.second->GetSpellInfo()->SpellName[0]);
+        }
+        if (!anyAura)
+            fmt::format_to(outItr, " None");
+    };
 
     if (inCombat)
     {
-        oss << "IN COMBAT: ";
+        fmt::format_to(outItr, "IN COMBAT: ");
         if (victim)
-        {
-            oss << "Target: " << safe_name(victim)
-                << " (guid: " << safe_guid(victim) << ")"
-                << ", Level: " << safe_level(victim)
-                << ", HP: " << safe_hp(victim) << "/" << safe_maxhp(victim);
-        }
+            appendUnit("Target: ", "", victim);
         else
-        {
-            oss << "No current target";
-        }
-        oss << ". ";
+            fmt::format_to(outItr, "No current target");
+        fmt::format_to(outItr, ". ");
 
         if (attacker)
         {
-            float dist = bot && attacker ? bot->GetDistance(attacker) : -1.0f;
+            float dist = bot->GetDistance(attacker);
 
             Creature* c = dynamic_cast<Creature*>(attacker);
             Player* p = dynamic_cast<Player*>(attacker);
 
-            oss << "DEFEND YOURSELF, YOU ARE UNDER ATTACK BY: ";
+            fmt::format_to(outItr, "DEFEND YOURSELF, YOU ARE UNDER ATTACK BY: ");
             if (c)
             {
                 // Creature-specific info
-                oss << "Creature '" << safe_name(c)
-                    << "' (guid: " << safe_guid(c) << ")"
-                    << ", Level: " << safe_level(c)
-                    << ", HP: " << safe_hp(c) << "/" << safe_maxhp(c)
-                    << ", Distance: " << (dist >= 0 ? (std::ostringstream() << std::fixed << std::setprecision(1) << dist).str() : "?")
-                    << ", Elite: " << (c->isElite() ? "Yes" : "No");
+                appendUnit("Creature ", "'", c);
+                fmt::format_to(outItr, ", Distance: {:.1f}, Elite: {}", dist, c->isElite() ? "Yes" : "No");
 
                 // Show auras/buffs/debuffs
-                oss << ", Auras:";
-                bool anyAura = false;
-                for (auto& auraPair : c->GetOwnedAuras())
-                {
-                    if (!anyAura) anyAura = true;
-                    oss << " " << auraPair.second->GetSpellInfo()->SpellName[0];
-                }
-                if (!anyAura) oss << " None";
+                appendAuras(c);
             }
             else if (p)
             {
                 // Player-specific info
-                std::string pFaction = (p->GetTeamId() == TEAM_ALLIANCE ? "Alliance" : "Horde");
-                oss << "Player '" << safe_name(p)
-                    << "' (guid: " << safe_guid(p) << ")"
-                    << ", Level: " << safe_level(p)
-                    << ", HP: " << safe_hp(p) << "/" << safe_maxhp(p)
-                    << ", Distance: " << (dist >= 0 ? (std::ostringstream() << std::fixed << std::setprecision(1) << dist).str() : "?")
-                    << ", Faction: " << pFaction
-                    << ", Class: " << std::to_string(p->getClass())
-                    << ", Race: " << std::to_string(p->getRace());
+                appendUnit("Player ", "'", p);
+                fmt::format_to(outItr, ", Distance: {:.1f}, Faction: {}, Class: {}, Race: {}",
+                    dist, p->GetTeamId() == TEAM_ALLIANCE ? "Alliance" : "Horde", p->getClass(), p->getRace());
 
                 // Show auras/buffs/debuffs
-                oss << ", Auras:";
-                bool anyAura = false;
-                for (auto& auraPair : p->GetOwnedAuras())
-                {
-                    if (!anyAura) anyAura = true;
-                    oss << " " << auraPair.second->GetSpellInfo()->SpellName[0];
-                }
-                if (!anyAura) oss << " None";
+                appendAuras(p);
             }
             else
             {
                 // Unknown Unit type
-                oss << safe_name(attacker)
-                    << " (guid: " << safe_guid(attacker) << ")"
-                    << ", Level: " << safe_level(attacker)
-                    << ", HP: " << safe_hp(attacker) << "/" << safe_maxhp(attacker)
-                    << ", Distance: " << (dist >= 0 ? (std::ostringstream() << std::fixed << std::setprecision(1) << dist).str() : "?");
+                appendUnit("", "", attacker);
+                fmt::format_to(outItr, ", Distance: {:.1f}", dist);
             }
 
-            oss << ". ";
+            fmt::format_to(outItr, ". ");
         }
 
-        oss << "Your HP: " << (bot ? std::to_string(bot->GetHealth()) : "?") << "/" << (bot ? std::to_string(bot->GetMaxHealth()) : "?");
-        oss << ", Mana: " << (bot ? std::to_string(bot->GetPower(POWER_MANA)) : "?") << "/" << (bot ? std::to_string(bot->GetMaxPower(POWER_MANA)) : "?");
-        oss << ", Energy: " << (bot ? std::to_string(bot->GetPower(POWER_ENERGY)) : "?") << "/" << (bot ? std::to_string(bot->GetMaxPower(POWER_ENERGY)) : "?");
+        fmt::format_to(outItr, "Your HP: ");
     }
     else
-    {
-        oss << "NOT IN COMBAT. Your HP: " << (bot ? std::to_string(bot->GetHealth()) : "?") << "/" << (bot ? std::to_string(bot->GetMaxHealth()) : "?");
-        oss << ", Mana: " << (bot ? std::to_string(bot->GetPower(POWER_MANA)) : "?") << "/" << (bot ? std::to_string(bot->GetMaxPower(POWER_MANA)) : "?");
-        oss << ", Energy: " << (bot ? std::to_string(bot->GetPower(POWER_ENERGY)) : "?") << "/" << (bot ? std::to_string(bot->GetMaxPower(POWER_ENERGY)) : "?");
-    }
-    return oss.str();
+        fmt::format_to(outItr, "NOT IN COMBAT. Your HP: ");
+
+    fmt::format_to(outItr, "{}/{}, Mana: {}/{}, Energy: {}/{}",
+        bot->GetHealth(), bot->GetMaxHealth(),
+        bot->GetPower(POWER_MANA), bot->GetMaxPower(POWER_MANA),
+        bot->GetPower(POWER_ENERGY), bot->GetMaxPower(POWER_ENERGY));
+
+    return fmt::to_string(out);
 }
 
 
-std::vector<std::string> GetNearbyWaypoints(Player* bot, float radius = 200.0f)
+std::vector<PromptEntry> GetNearbyWaypoints(Player* bot, float radius = 200.0f)
 {
-    std::vector<std::string> wps;
+    std::vector<PromptEntry> wps;
     if (!bot) return wps;
-    uint32 bot_map = bot->GetMapId();
-    float bot_x = bot->GetPositionX();
-    float bot_y = bot->GetPositionY();
-    float bot_z = bot->GetPositionZ();
-
-    auto nodes = sTravelNodeMap->getNodes();
-    int idx = 0;
-    for (TravelNode* node : nodes)
+
+    std::vector<NearbyTravelNode> nodes;
+    QueryNearbyTravelNodes(bot->GetMapId(), bot->GetPositionX(), bot->GetPositionY(), bot->GetPositionZ(), radius, nodes);
+
+    wps.reserve(nodes.size());
+    for (NearbyTravelNode const& nearby : nodes)
     {
-        if (!node) continue;
-        WorldPosition* pos = node->getPosition();
-        if (!pos) continue;
-        if (pos->getMapId() != bot_map) continue;
-        float dx = pos->getX() - bot_x;
-        float dy = pos->getY() - bot_y;
-        float dz = pos->getZ() - bot_z;
-        float dist = sqrtf(dx*dx + dy*dy + dz*dz);
-        if (dist > radius) continue;
-        wps.push_back(fmt::format("Node #{} '{}' ({:.1f}, {:.1f}, {:.1f}), distance: {:.1f}", idx, node->getName(), pos->getX(), pos->getY(), pos->getZ(), dist));        
-        ++idx;
+        // Keyed by position, the node's rank in the list changes as the bot moves
+        float dist = std::sqrt(nearby.distSq);
+        wps.push_back({ fmt::format("w{:.1f},{:.1f},{:.1f}", nearby.x, nearby.y, nearby.z),
+            fmt::format("Node '{}' ({:.1f}, {:.1f}, {:.1f}), distance: {:.1f}", nearby.node->getName(), nearby.x, nearby.y, nearby.z, dist), -dist });
     }
     return wps;
 }
 
 OllamaBotControlLoop::OllamaBotControlLoop() : WorldScript("OllamaBotControlLoop") {}
 
-static std::unordered_map<uint64_t, time_t> nextTick;
-
-static size_t WriteCallback(void* contents, size_t size, size_t nmemb, void* userp)
-{
-    std::string* responseBuffer = static_cast<std::string*>(userp);
-    size_t totalSize = size * nmemb;
-    responseBuffer->append(static_cast<char*>(contents), totalSize);
-    return totalSize;
-}
-
-static std::string QueryOllamaLLM(const std::string& prompt)
-{
-    CURL* curl = curl_easy_init();
-    if (!curl)
-    {
-        LOG_INFO("server.loading", "[OllamaBotBuddy] Failed to initialize cURL.");
-        return "";
-    }
-
-    nlohmann::json requestData = {
-        {"model",  g_OllamaBotControlModel},
-        {"prompt", prompt}
-    };
-    std::string requestDataStr = requestData.dump();
-
-    struct curl_slist* headers = nullptr;
-    headers = curl_slist_append(headers, "Content-Type: application/json");
-
-    std::string responseBuffer;
-    curl_easy_setopt(curl, CURLOPT_URL, g_OllamaBotControlUrl.c_str());
-    curl_easy_setopt(curl, CURLOPT_POST, 1L);
-    curl_easy_setopt(curl, CURLOPT_POSTFIELDS, requestDataStr.c_str());
-    curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, long(requestDataStr.length()));
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &responseBuffer);
-    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-
-    CURLcode res = curl_easy_perform(curl);
-    curl_slist_free_all(headers);
-    curl_easy_cleanup(curl);
-
-    if (res != CURLE_OK)
-    {
-        LOG_INFO("server.loading", "[OllamaBotBuddy] Failed to reach Ollama AI. cURL error: {}", curl_easy_strerror(res));
-        return "";
-    }
-
-    std::stringstream ss(responseBuffer);
-    std::string line, extracted;
-    while (std::getline(ss, line))
-    {
-        try
-        {
-            nlohmann::json jsonResponse = nlohmann::json::parse(line);
-            if (jsonResponse.contains("response"))
-                extracted += jsonResponse["response"].get<std::string>();
-        }
-        catch (...) {}
-    }
-    return extracted;
-}
 
-static std::string BuildBotPrompt(Player* bot)
+// Everything the model knows about the bot and its surroundings, as keyed
+// sections so that delta mode can tell what changed since the last decision
+static BotPromptSnapshot BuildBotPromptSnapshot(Player* bot, PlayerbotAI* botAI)
 {
-    PlayerbotAI* botAI = sPlayerbotsMgr->GetPlayerbotAI(bot);
-    if (!botAI) return "";
-
     AreaTableEntry const* botCurrentArea = botAI->GetCurrentArea();
     AreaTableEntry const* botCurrentZone = botAI->GetCurrentZone();
 
-    std::vector<std::string> groupInfo = GetGroupStatus(bot);
-
-    std::string botName             = bot->GetName();
-    uint32_t botLevel               = bot->GetLevel();
     uint8_t botGenderByte           = bot->getGender();
     std::string botAreaName         = botCurrentArea ? botAI->GetLocalizedAreaName(botCurrentArea): "UnknownArea";
     std::string botZoneName         = botCurrentZone ? botAI->GetLocalizedAreaName(botCurrentZone): "UnknownZone";
@@ -824,85 +652,151 @@ static std::string BuildBotPrompt(Player* bot)
     std::string botFaction          = (bot->GetTeamId() == TEAM_ALLIANCE ? "Alliance" : "Horde");
     std::string botGroupStatus      = (bot->GetGroup() ? "In a group" : "Solo");
     uint32_t botGold                = bot->GetMoney() / 10000;
-    
 
-    std::ostringstream oss;
-    oss << "Bot state summary:\n";
-    oss << "Name: " << botName << "\n";
-    oss << "Level: " << botLevel << "\n";
-    oss << "Class: " << botClass << "\n";
-    oss << "Race: " << botRace << "\n";
-    oss << "Gender: " << botGender << "\n";
-    oss << "Faction: " << botFaction << "\n";
-    oss << "Gold: " << botGold << "\n";
-    oss << "Area: " << botAreaName << "\n";
-    oss << "Zone: " << botZoneName << "\n";
-    oss << "Map: " << botMapName << "\n";
-    oss << "Position: " << bot->GetPositionX() << " " << bot->GetPositionY() << " " << bot->GetPositionZ() << "\n";
-
-    oss << GetCombatSummary(bot) << "\n\n";
-
-    oss << "Your known spells:\n" << GetBotSpellInfo(bot) << "\n\n";
-
-    oss << "Group status: " << botGroupStatus << "\n";
-    if (!groupInfo.empty()) {
-        oss << "Group members:\n";
-        for (const auto& entry : groupInfo) oss << " - " << entry << "\n";
-    }
+    BotPromptSnapshot snapshot;
 
-    oss << "Active quests:\n";
-    for (auto const& qs : bot->getQuestStatusMap())
+    PromptSection& summary = snapshot.emplace_back();
+    summary.name = "summary";
+    summary.title = "Bot state summary:";
+    auto addStat = [&summary](char const* key, std::string const& value) {
+        summary.entries.push_back({ key, fmt::format("{}: {}", key, value) });
+    };
+    addStat("Name", bot->GetName());
+    addStat("Level", std::to_string(bot->GetLevel()));
+    addStat("Class", botClass);
+    addStat("Race", botRace);
+    addStat("Gender", botGender);
+    addStat("Faction", botFaction);
+    addStat("Gold", std::to_string(botGold));
+    addStat("Area", botAreaName);
+    addStat("Zone", botZoneName);
+    addStat("Map", botMapName);
+    addStat("Position", fmt::format("{} {} {}", bot->GetPositionX(), bot->GetPositionY(), bot->GetPositionZ()));
+
+    PromptSection& combat = snapshot.emplace_back();
+    combat.name = "combat";
+    combat.entries.push_back({ "combat", GetCombatSummary(bot) });
+    combat.blankLineAfter = true;
+
+    PromptSection& spells = snapshot.emplace_back();
+    spells.name = "spells";
+    spells.title = "Your known spells:";
+    std::string spellInfo = GetBotSpellInfo(bot);
+    for (size_t pos = 0, next; pos < spellInfo.size(); pos = next + 1)
     {
-        oss << "Quest " << qs.first << " status " << qs.second.Status << "\n";
+        next = spellInfo.find('\n', pos);
+        if (next == std::string::npos)
+            next = spellInfo.size();
+        if (next > pos)
+            spells.entries.push_back({ spellInfo.substr(pos, next - pos), spellInfo.substr(pos, next - pos) });
     }
+    spells.blankLineAfter = true;
 
-    std::vector<std::string> losLocs = GetVisibleLocations(bot);
-    std::vector<std::string> wps = GetNearbyWaypoints(bot);
+    PromptSection& group = snapshot.emplace_back();
+    group.name = "group";
+    group.entries.push_back({ "status", "Group status: " + botGroupStatus });
 
-    if (!losLocs.empty()) {
-        oss << "Visible locations/objects in line of sight:\n";
-        for (const auto& entry : losLocs) oss << " - " << entry << "\n";
-    }
+    PromptSection& members = snapshot.emplace_back();
+    members.name = "members";
+    members.title = "Group members:";
+    members.bullet = " - ";
+    members.entries = GetGroupStatus(bot);
 
-    if (!wps.empty()) {
-        oss << "Nearby navigation waypoints:\n";
-        for (const auto& entry : wps) oss << " - " << entry << "\n";
-    }
-
-    std::vector<std::string> nearbyPlayers = GetVisiblePlayers(bot);
-    if (!nearbyPlayers.empty()) {
-        oss << "Visible players in area:\n";
-        for (const auto& entry : nearbyPlayers) oss << " - " << entry << "\n";
-    }
-
-    if (!losLocs.empty() || !wps.empty()) {
-        oss << "You must select one of these locations or waypoints to move to, interact with, accept or turn in quests, attack, loot, or any other action or choose a new unexplored spot.\n";
+    PromptSection& quests = snapshot.emplace_back();
+    quests.name = "quests";
+    quests.title = "Active quests:";
+    for (auto const& qs : bot->getQuestStatusMap())
+        quests.entries.push_back({ std::to_string(qs.first), fmt::format("Quest {} status {}", qs.first, qs.second.Status) });
+
+    PromptSection& locations = snapshot.emplace_back();
+    locations.name = "locations";
+    locations.title = "Visible locations/objects in line of sight:";
+    locations.bullet = " - ";
+    locations.entries = GetVisibleLocations(bot);
+    FitPromptSection(locations, g_OllamaBotControlLocationsTokenBudget);
+
+    PromptSection& waypoints = snapshot.emplace_back();
+    waypoints.name = "waypoints";
+    waypoints.title = "Nearby navigation waypoints:";
+    waypoints.bullet = " - ";
+    waypoints.entries = GetNearbyWaypoints(bot);
+    FitPromptSection(waypoints, g_OllamaBotControlWaypointsTokenBudget);
+
+    PromptSection& players = snapshot.emplace_back();
+    players.name = "players";
+    players.title = "Visible players in area:";
+    players.bullet = " - ";
+    players.entries = GetVisiblePlayers(bot);
+    FitPromptSection(players, g_OllamaBotControlPlayersTokenBudget);
+
+    if (!locations.entries.empty() || !waypoints.entries.empty())
+    {
+        PromptSection& hint = snapshot.emplace_back();
+        hint.name = "hint";
+        hint.entries.push_back({ "hint", "You must select one of these locations or waypoints to move to, interact with, accept or turn in quests, attack, loot, or any other action or choose a new unexplored spot." });
     }
 
-    oss << FormatPlayerMessagesPromptSegment(bot);
+    return snapshot;
+}
 
-    std::vector<std::string> cmdHist = GetBotCommandHistory(bot);
+// Renders the bot's state, or only what changed since the last decision in delta mode
+static BotPromptSnapshot CollectBotPromptSnapshot(Player* bot)
+{
+    PlayerbotAI* botAI = sPlayerbotsMgr->GetPlayerbotAI(bot);
+    if (!botAI) return {};
 
-    std::vector<std::string> reasoningHist = GetBotReasoningHistory(bot);
+    // The targets the reply may refer to are exactly the ones listed in this prompt
+    ResetBotTargetIndex(bot);
+    PruneBotLosCache(bot);
 
+    return BuildBotPromptSnapshot(bot, botAI);
+}
 
-    if (!cmdHist.empty() && !reasoningHist.empty())
-    {
-        oss << "Last 5 commands and their reasoning (most recent at the bottom):\n";
-        for (size_t i = 0; i < cmdHist.size() && i < reasoningHist.size(); ++i)
-        {
-            oss << " - Command: " << cmdHist[i] << "\n";
-            oss << "   Reasoning: " << reasoningHist[i] << "\n";
-        }
-    }
+static void BuildBotPrompt(PromptBuffer& out, Player* bot, BotPromptSnapshot snapshot, bool& keyframe)
+{
+    size_t start = out.size();
+    keyframe = true;
+    if (IsDeltaPromptEnabled())
+        BuildBotDeltaPrompt(out, bot->GetGUID(), std::move(snapshot), keyframe);
+    else
+        RenderPromptSnapshot(out, snapshot);
 
     if (g_EnableOllamaBotBuddyDebug)
     {
-        std::string safeSnapshot = EscapeBracesForFmt(oss.str());
-        LOG_INFO("server.loading", "[OllamaBotBuddy] Bot Snapshot for '{}': {}", botName, safeSnapshot);
+        std::string safeSnapshot = EscapeBracesForFmt(std::string(out.data() + start, out.size() - start));
+        LOG_INFO("server.loading", "[OllamaBotBuddy] Bot Snapshot for '{}': {}", bot->GetName(), safeSnapshot);
     }
+}
+
+// What happened since the last decision: player messages and, outside of
+// session mode, the previous commands. Never part of a delta, always sent as is.
+static void BuildBotPromptEvents(PromptBuffer& out, Player* bot, BotPlayerMessages& playerMessages)
+{
+    AppendPlayerMessagesPrompt(out, bot, playerMessages);
 
-    oss << R"(You are an AI-controlled bot in World of Warcraft. Your task is to follow these strict rules and reply only with the listed acceptable commands:
+    // In session mode the previous replies are already part of the conversation
+    if (g_OllamaBotControlSession)
+        return;
+
+    uint64_t guid = bot->GetGUID().GetRawValue();
+    std::lock_guard<std::mutex> commandLock(botCommandHistoryMutex);
+    std::lock_guard<std::mutex> reasoningLock(botReasoningHistoryMutex);
+    auto cmdHist = botCommandHistory.find(guid);
+    auto reasoningHist = botReasoningHistory.find(guid);
+    if (cmdHist == botCommandHistory.end() || cmdHist->second.empty() || reasoningHist == botReasoningHistory.end() || reasoningHist->second.empty())
+        return;
+
+    auto outItr = std::back_inserter(out);
+    fmt::format_to(outItr, "Last 5 commands and their reasoning (most recent at the bottom):\n");
+    for (size_t i = 0; i < cmdHist->second.size() && i < reasoningHist->second.size(); ++i)
+        fmt::format_to(outItr, " - Command: {}\n   Reasoning: {}\n", cmdHist->second[i], reasoningHist->second[i]);
+}
+
+// Static instructions, identical for every bot and every decision. Appended to
+// the state in stateless mode, sent as the system prompt in session mode.
+static const std::string& GetBotRulesPrompt()
+{
+    static const std::string rules = R"(You are an AI-controlled bot in World of Warcraft. Your task is to follow these strict rules and reply only with the listed acceptable commands:
 
     Primary goal: Level to 80 and equip the best gear. Prioritize combat, questing and quest givers, talking to other players and efficient progression. If no quests or viable enemies are nearby, explore for new quests, dungeons, raids, professions, or gold opportunities.
 
@@ -942,16 +836,7 @@ static std::string BuildBotPrompt(Player* bot)
 
     Allowed "type" values and required params:
 
-    - "move_to": params = { "x": float, "y": float, "z": float }
-    - "attack": params = { "guid": int }
-    - "interact": params = { "guid": int }
-    - "spell": params = { "spellid": int, "guid": int (omit if self-cast) }
-    - "loot": params = { }
-    - "accept_quest": params = { "id": int }
-    - "turn_in_quest": params = { "id": int }
-    - "follow": params = { }
-    - "stop": params = { }
-
+)" + BuildBotCommandListPrompt() + R"(
     "reasoning" must be a short natural-language explanation for why you chose this command.
     "say" must be what your character would say in-game to players, or "" if nothing is to be said. You can use this to communicate with players, but do not use it for commands.
 
@@ -975,18 +860,181 @@ static std::string BuildBotPrompt(Player* bot)
     REMEMBER: NEVER REPLY WITH ANYTHING OTHER THAN A VALID JSON OBJECT!!!
     )";
 
-
-    return oss.str();
+    return rules;
 }
 
 namespace
 {
     struct OllamaBotState
     {
-        std::atomic<bool> busy { false };
+        bool busy { false };  // world thread only
         time_t lastRequest { 0 };
+        uint64 lastReplyMs { 0 };
+        uint64 decisionKey { 0 };  // decision cache key of the request in flight, 0 if not cacheable
     };
+
+    // Retry delay for bots that could not be dispatched (no AI yet, request queue full)
+    constexpr uint32 BOT_RETRY_DELAY_MS = 1000;
+    // How often a bot walking to a move command's point is checked for arrival
+    constexpr uint32 BOT_MOVE_POLL_MS = 500;
+    // A point move that takes longer than this is assumed stuck and no longer delays the next decision
+    constexpr uint32 BOT_MAX_MOVE_PAUSE_MS = 30000;
     std::unordered_map<uint64_t, OllamaBotState> ollamaBotStates;
+
+    // Outcome of one LLM round trip. Produced by the I/O thread or a worker,
+    // applied by OnUpdate on the world thread.
+    struct BotReply
+    {
+        ObjectGuid botGuid;
+        std::string prompt;
+        bool parsed = false;
+        BotDecision decision;
+    };
+    // Owns the queued replies, Dequeue hands them over to the world thread
+    MPSCQueue<BotReply> botReplyMailbox;
+
+    // Prompts collected for the next batched request, world thread only
+    struct BatchedPrompt
+    {
+        ObjectGuid botGuid;
+        std::string botName;
+        std::string prompt;
+        BotPlayerMessages playerMessages;
+    };
+    std::vector<BatchedPrompt> pendingBatch;
+    uint64 pendingBatchSinceMs = 0;
+}
+
+void ResetOllamaBotState(ObjectGuid botGuid)
+{
+    auto itr = ollamaBotStates.find(botGuid.GetRawValue());
+    // A request in flight still needs its busy flag, the reply drops the state
+    if (itr != ollamaBotStates.end() && !itr->second.busy)
+        ollamaBotStates.erase(itr);
+}
+
+static bool IsBatchingEnabled()
+{
+    // Sessions are one conversation per bot, they cannot be shared
+    return g_OllamaBotControlBatchSize > 1 && !g_OllamaBotControlSession;
+}
+
+// The rules are shared by every bot of a batch, so they come first and only once
+static std::string BuildBatchPrompt(std::vector<BatchedPrompt> const& batch)
+{
+    PromptBuffer& out = GetBotPromptBuffer();
+    auto outItr = std::back_inserter(out);
+    std::string const& rules = GetBotRulesPrompt();
+    out.append(rules.data(), rules.data() + rules.size());
+    fmt::format_to(outItr, "\nBATCH MODE: You control {} bots at once. The rules above describe the reply for one bot. "
+        "Reply with ONLY a JSON array of {} such objects, one per bot in the order listed below, "
+        "each with an added top-level \"bot\" field set to the bot's name.\n", batch.size(), batch.size());
+
+    for (BatchedPrompt const& entry : batch)
+        fmt::format_to(outItr, "\n### Bot: {}\n{}", entry.botName, entry.prompt);
+
+    return fmt::to_string(out);
+}
+
+// Splits a batched reply into one BotReply per bot. Runs on a worker.
+static void DemultiplexBatchReply(std::vector<BatchedPrompt> const& batch, OllamaResponse const& response)
+{
+    std::vector<BotReply> replies(batch.size());
+    std::unordered_map<std::string, size_t> byName;
+    for (size_t i = 0; i < batch.size(); ++i)
+    {
+        replies[i].botGuid = batch[i].botGuid;
+        replies[i].prompt = batch[i].prompt;
+        byName.emplace(ToLowerBotName(batch[i].botName), i);
+    }
+
+    std::string llmReply = response.ok ? response.text : "";
+    if (g_EnableOllamaBotBuddyDebug)
+        LOG_INFO("server.loading", "[OllamaBotBuddy] LLM reply for a batch of {} bots:\n{}", batch.size(), llmReply);
+
+    // The stream parser already cut the array out, the decoder finds it in the raw text otherwise
+    std::string_view jsonText = response.json.empty() ? std::string_view(llmReply) : std::string_view(response.json);
+    auto parseStart = std::chrono::steady_clock::now();
+    std::vector<DecodedBotDecision> decisions = DecodeBotDecisionBatch(jsonText);
+
+    for (size_t i = 0; i < decisions.size(); ++i)
+    {
+        DecodedBotDecision& decision = decisions[i];
+        if (!decision.ok)
+            continue;
+
+        // Matched by name, models do not always keep the order
+        size_t index = i;
+        if (!decision.bot.empty())
+        {
+            auto itr = byName.find(ToLowerBotName(decision.bot));
+            if (itr == byName.end())
+                continue;
+            index = itr->second;
+        }
+        if (index >= replies.size() || replies[index].parsed)
+            continue;
+
+        replies[index].decision = std::move(decision.decision);
+        replies[index].parsed = true;
+    }
+
+    RecordBotLatency(BotLatencyStage::Parse, std::chrono::steady_clock::now() - parseStart);
+
+    if (decisions.empty() && !llmReply.empty())
+        LOG_ERROR("server.loading", "[OllamaBotBuddy] No valid JSON array found in batched LLM reply: {}", llmReply);
+
+    // Counted per bot, as if each had asked on its own
+    if (!llmReply.empty())
+        for (BotReply const& reply : replies)
+            if (!reply.parsed)
+                CountBotEvent(BotCounter::ParseErrors);
+
+    // Every bot of the batch gets an answer, parsed or not, so none stays busy
+    for (BotReply& reply : replies)
+        botReplyMailbox.Enqueue(new BotReply(std::move(reply)));
+}
+
+static void FlushBotBatch(uint64 now)
+{
+    if (pendingBatch.empty())
+        return;
+
+    auto batch = std::make_shared<std::vector<BatchedPrompt>>(std::move(pendingBatch));
+    pendingBatch.clear();
+
+    std::string body = BuildOllamaGenerateBody(BuildBatchPrompt(*batch), GetBotBatchFormat(batch->size()));
+    bool submitted = sOllamaHttpClient->Submit(OllamaEndpoint::Generate, std::move(body), [batch](OllamaResponse&& response) {
+        // Runs on the I/O thread, hand the reply over to a worker
+        bool queued = sOllamaWorkerPool->Enqueue([batch, response = std::move(response)]() {
+            DemultiplexBatchReply(*batch, response);
+        });
+
+        // Still report back so the bots do not stay busy forever
+        if (!queued)
+        {
+            for (BatchedPrompt const& entry : *batch)
+            {
+                RestorePlayerMessages(entry.botGuid, entry.playerMessages);
+                BotReply reply;
+                reply.botGuid = entry.botGuid;
+                botReplyMailbox.Enqueue(new BotReply(std::move(reply)));
+            }
+        }
+    }, true);
+
+    // Too many requests waiting, try again on a later update
+    if (!submitted)
+    {
+        for (BatchedPrompt const& entry : *batch)
+        {
+            RestorePlayerMessages(entry.botGuid, entry.playerMessages);
+            ollamaBotStates[entry.botGuid.GetRawValue()].busy = false;
+            ScheduleBotDecision(entry.botGuid, now + BOT_RETRY_DELAY_MS);
+        }
+        if (g_EnableOllamaBotBuddyDebug)
+            LOG_INFO("server.loading", "[OllamaBotBuddy] Request queue full, deferring a batch of {} decisions", batch->size());
+    }
 }
 
 std::string EscapeBracesForFmt(const std::string& input) {
@@ -1004,71 +1052,378 @@ std::string EscapeBracesForFmt(const std::string& input) {
     return output;
 }
 
+void OllamaBotControlLoop::OnStartup()
+{
+    LoadControlledBotConfig();
+    LoadBotReflexConfig();
+    BuildSpellDescriptorTable();
+    InitOllamaHttp();
+    sOllamaWorkerPool->Start(g_OllamaBotControlWorkerThreads, g_OllamaBotControlMaxQueuedRequests);
+    sOllamaHttpClient->Start(g_OllamaBotControlMaxInFlightRequests, g_OllamaBotControlMaxQueuedRequests, g_OllamaBotControlRequestTimeout);
+}
+
+void OllamaBotControlLoop::OnShutdown()
+{
+    sOllamaHttpClient->Stop();
+    sOllamaWorkerPool->Stop();
+    ShutdownOllamaHttp();
+}
+
+static void LogOllamaBotBuddyStatus(uint32 intervalMs)
+{
+    static uint64 lastBusyTimeUs = 0;
+
+    uint32 workers = sOllamaWorkerPool->GetWorkerCount();
+    uint64 busyTimeUs = sOllamaWorkerPool->GetBusyTimeUs();
+    uint64 busyDeltaUs = busyTimeUs - lastBusyTimeUs;
+    lastBusyTimeUs = busyTimeUs;
+
+    float utilization = (workers && intervalMs) ? 100.0f * float(busyDeltaUs) / (float(intervalMs) * 1000.0f * float(workers)) : 0.0f;
+
+    LOG_INFO("server.loading", "[OllamaBotBuddy] Workers: {}/{} busy, utilization {:.1f}%, queue {}/{}, completed {}, rejected {}",
+        sOllamaWorkerPool->GetBusyWorkers(), workers, utilization,
+        sOllamaWorkerPool->GetQueueDepth(), sOllamaWorkerPool->GetMaxQueueDepth(),
+        sOllamaWorkerPool->GetCompletedJobs(), sOllamaWorkerPool->GetRejectedJobs());
+
+    LOG_INFO("server.loading", "[OllamaBotBuddy] Requests: {} in flight, {} pending, {} completed, {} failed",
+        sOllamaHttpClient->GetInFlight(), sOllamaHttpClient->GetPending(),
+        sOllamaHttpClient->GetCompleted(), sOllamaHttpClient->GetFailed());
+
+    uint64 losHits = GetLosCacheHits();
+    uint64 losMisses = GetLosCacheMisses();
+    LOG_INFO("server.loading", "[OllamaBotBuddy] LOS cache: {} hits, {} misses ({:.1f}% hit rate)",
+        losHits, losMisses, (losHits + losMisses) ? 100.0f * float(losHits) / float(losHits + losMisses) : 0.0f);
+
+    if (g_OllamaBotControlSession)
+        LOG_INFO("server.loading", "[OllamaBotBuddy] Sessions: {} resets", GetBotSessionResets());
+
+    LOG_INFO("server.loading", "[OllamaBotBuddy] Scheduler: {} controlled bots, {} waiting for their next decision",
+        GetControlledBots().size(), GetScheduledBotCount());
+
+    if (IsDecisionCacheEnabled())
+    {
+        uint64 hits = GetDecisionCacheHits();
+        uint64 misses = GetDecisionCacheMisses();
+        LOG_INFO("server.loading", "[OllamaBotBuddy] Decision cache: {} entries, {} hits, {} misses ({:.1f}% hit rate)",
+            GetDecisionCacheSize(), hits, misses, (hits + misses) ? 100.0f * float(hits) / float(hits + misses) : 0.0f);
+    }
+
+    if (HasEnabledBotReflexes())
+    {
+        uint64 saved = 0;
+        std::string perReflex;
+        for (BotReflexStats const& stats : GetBotReflexStats())
+        {
+            if (!stats.enabled)
+                continue;
+            saved += stats.fired;
+            perReflex += fmt::format("{}{} {}", perReflex.empty() ? "" : ", ", stats.name, stats.fired);
+        }
+        LOG_INFO("server.loading", "[OllamaBotBuddy] Reflexes: {} LLM calls saved ({})", saved, perReflex);
+    }
+
+    LOG_INFO("server.loading", "[OllamaBotBuddy] Prompt budget: {} sections truncated, {} entries dropped",
+        GetTruncatedSectionCount(), GetDroppedEntryCount());
+
+    if (IsDeltaPromptEnabled())
+        LOG_INFO("server.loading", "[OllamaBotBuddy] Prompts: {} deltas, {} keyframes", GetDeltaPromptCount(), GetKeyframePromptCount());
+
+    uint64 requests = 0;
+    uint64 newConnections = 0;
+    size_t handles = 0;
+    for (auto const& backend : GetOllamaBackends())
+    {
+        OllamaBackendStats stats = backend->GetStats();
+        LOG_INFO("server.loading", "[OllamaBotBuddy] Backend {}: {}, {} outstanding, {} requests, {} failed, {} ms average latency",
+            stats.url, stats.healthy ? "healthy" : "EJECTED", stats.outstanding, stats.requests, stats.failures, stats.averageLatencyMs);
+
+        std::vector<OllamaConnectionStats> connections = backend->GetPool().GetStats();
+        handles += connections.size();
+        for (OllamaConnectionStats const& connection : connections)
+        {
+            requests += connection.requests;
+            newConnections += connection.newConnections;
+            if (g_EnableOllamaBotBuddyDebug)
+                LOG_INFO("server.loading", "[OllamaBotBuddy] Connection #{} to {}: {} requests, {} new connections, {} reused",
+                    connection.id, stats.url, connection.requests, connection.newConnections, connection.requests - std::min(connection.requests, connection.newConnections));
+        }
+    }
+    LOG_INFO("server.loading", "[OllamaBotBuddy] Connections: {} handles, {} requests, {} new connections, {} reused",
+        handles, requests, newConnections, requests - std::min(requests, newConnections));
+
+    for (std::string const& line : FormatBotStats())
+        LOG_INFO("server.loading", "[OllamaBotBuddy] Stats: {}", line);
+}
+
+// Applies LLM replies on the world thread, bounded by a per-tick count and time budget
+static void DrainBotReplies()
+{
+    auto start = std::chrono::steady_clock::now();
+    auto budget = std::chrono::milliseconds(g_OllamaBotControlCommandBudgetMs);
+
+    uint64 now = GameTime::GetGameTimeMS().count();
+    uint32 processed = 0;
+    BotReply* queued = nullptr;
+    while (processed < g_OllamaBotControlMaxCommandsPerTick && botReplyMailbox.Dequeue(queued))
+    {
+        ++processed;
+        std::unique_ptr<BotReply> owned(queued);
+        BotReply& reply = *owned;
+
+        // Mark ready for the next request
+        auto stateItr = ollamaBotStates.find(reply.botGuid.GetRawValue());
+        if (stateItr != ollamaBotStates.end())
+        {
+            stateItr->second.busy = false;
+            stateItr->second.lastReplyMs = now;
+            if (reply.parsed && stateItr->second.decisionKey)
+                StoreCachedDecision(stateItr->second.decisionKey, reply.decision, now);
+
+            // Released while the request was in flight, the worker may have recorded the turn after the release
+            if (!IsControlledBot(reply.botGuid))
+            {
+                ollamaBotStates.erase(stateItr);
+                ResetBotSession(reply.botGuid);
+            }
+        }
+
+        Player* bot = ObjectAccessor::FindPlayer(reply.botGuid);
+        if (!bot)
+        {
+            RemoveBotTargetIndex(reply.botGuid);
+            RemoveBotLosCache(reply.botGuid);
+            ResetBotSession(reply.botGuid);
+            RemoveBotSpellSummary(reply.botGuid);
+            ResetBotPromptDelta(reply.botGuid);
+            ResetBotReflexes(reply.botGuid);
+            continue;
+        }
+
+        // The conversation did not record this turn, so the next delta would refer to a state the model never saw
+        if (!reply.parsed)
+            ResetBotPromptDelta(reply.botGuid);
+
+        // Released while the request was in flight
+        if (bot->IsInWorld() && reply.parsed && IsControlledBot(reply.botGuid))
+        {
+            SendBuddyBotStateToPlayer(bot, bot, reply.prompt);
+            ExecuteBotDecision(bot, reply.decision);
+        }
+
+        // Paced by what the bot is doing now that the decision has been applied
+        if (IsControlledBot(reply.botGuid))
+            ScheduleBotDecision(reply.botGuid, now + GetBotDecisionInterval(bot));
+
+        if (g_OllamaBotControlCommandBudgetMs && std::chrono::steady_clock::now() - start >= budget)
+            break;
+    }
+}
+
 void OllamaBotControlLoop::OnUpdate(uint32 diff)
 {
+    // Emptied even while disabled, the spell hooks keep filling it
+    ProcessBotSpellChanges();
+
     if (!g_EnableOllamaBotControl) return;
 
-    for (auto const& itr : ObjectAccessor::GetPlayers())
+    static uint32 statusTimer = 0;
+    if (g_OllamaBotControlStatusLogInterval)
     {
-        Player* bot = itr.second;
-        if (!bot->IsInWorld()) continue;
-        std::string botName = bot->GetName();
+        statusTimer += diff;
+        if (statusTimer >= g_OllamaBotControlStatusLogInterval * IN_MILLISECONDS)
+        {
+            LogOllamaBotBuddyStatus(statusTimer);
+            statusTimer = 0;
+        }
+    }
 
-        // Temporary marker for testing
-        if (botName != "Ollamatest") continue;
+    DrainBotReplies();
 
-        // Clear the normal Playerbot AI
-        PlayerbotAI* ai = sPlayerbotsMgr->GetPlayerbotAI(bot);
-        if (ai)
+    // Picks up travel nodes regenerated by playerbots
+    static uint32 waypointIndexTimer = 0;
+    if (g_OllamaBotControlWaypointIndexCheckInterval)
+    {
+        waypointIndexTimer += diff;
+        if (waypointIndexTimer >= g_OllamaBotControlWaypointIndexCheckInterval * IN_MILLISECONDS)
         {
-            ai->ClearStrategies(BOT_STATE_COMBAT);
-            ai->ClearStrategies(BOT_STATE_NON_COMBAT);
-            ai->ClearStrategies(BOT_STATE_DEAD);
-        } else {
+            CheckTravelNodeIndex();
+            waypointIndexTimer = 0;
+        }
+    }
+
+    // Only the bots due for a decision are touched, idle ones sit in the heap
+    uint64 now = GameTime::GetGameTimeMS().count();
+    ObjectGuid dueGuid;
+    while (PopDueBotDecision(now, dueGuid))
+    {
+        ControlledBot* controlled = FindControlledBot(dueGuid);
+        if (!controlled) continue;
+
+        // Logged out bots leave the registry on their own
+        Player* bot = ObjectAccessor::FindConnectedPlayer(dueGuid);
+        if (!bot) continue;
+
+        if (!bot->IsInWorld() || !TakeOverControlledBot(bot, *controlled))
+        {
+            ScheduleBotDecision(dueGuid, now + BOT_RETRY_DELAY_MS);
             continue;
         }
 
-        uint64_t guid = bot->GetGUID().GetRawValue();
+        uint64_t guid = dueGuid.GetRawValue();
+        std::string botName = bot->GetName();
         OllamaBotState& state = ollamaBotStates[guid];
 
+        // Let the bot reach the point it was sent to, unless it gets attacked on the way
+        if (!state.busy && !bot->IsInCombat() && IsBotMovingToPoint(bot) && now - state.lastReplyMs < BOT_MAX_MOVE_PAUSE_MS)
+        {
+            ScheduleBotDecision(dueGuid, now + BOT_MOVE_POLL_MS);
+            continue;
+        }
+
+        // Obvious actions are taken right away, even while the LLM is still thinking about the bot.
+        // A busy bot is scheduled again once its reply is applied.
+        if (RunBotReflexes(bot))
+        {
+            if (!state.busy)
+                ScheduleBotDecision(dueGuid, now + GetBotDecisionInterval(bot));
+            continue;
+        }
+
         // Only process if not already waiting for LLM
         if (!state.busy)
         {
+            auto promptStart = std::chrono::steady_clock::now();
+            BotPromptSnapshot snapshot = CollectBotPromptSnapshot(bot);
+
+            // Same situation as an earlier decision, no need to ask again. Players talking to the bot always get a real answer.
+            state.decisionKey = 0;
+            if (IsDecisionCacheEnabled() && !HasPendingPlayerMessages(bot))
+            {
+                state.decisionKey = HashBotDecisionState(bot, snapshot);
+                if (BotControlCommand const* cached = FindCachedDecision(state.decisionKey, now))
+                {
+                    // Not a new decision: nothing to say and nothing to add to the history
+                    if (HandleBotControlCommand(bot, *cached))
+                    {
+                        ScheduleBotDecision(dueGuid, now + GetBotDecisionInterval(bot));
+                        continue;
+                    }
+
+                    // No longer applies (target gone, already looted), the LLM decides this time
+                    EraseCachedDecision(state.decisionKey);
+                }
+            }
+
             state.busy = true;
             state.lastRequest = time(nullptr);
 
-            std::string prompt = BuildBotPrompt(bot);
+            PromptBuffer& promptBuffer = GetBotPromptBuffer();
+            bool keyframe = true;
+            BuildBotPrompt(promptBuffer, bot, std::move(snapshot), keyframe);
+            size_t stateSize = promptBuffer.size();
+            BotPlayerMessages playerMessages;
+            BuildBotPromptEvents(promptBuffer, bot, playerMessages);
+            std::string prompt = fmt::to_string(promptBuffer);
+            RecordBotLatency(BotLatencyStage::Prompt, std::chrono::steady_clock::now() - promptStart);
 
             if (g_EnableOllamaBotBuddyDebug)
             {
                 //LOG_INFO("server.loading", "[OllamaBotBuddy] Sending prompt for bot '{}': {}", botName, prompt);
             }
 
-            std::thread([bot, guid, prompt]() {
-                std::string llmReply = QueryOllamaLLM(prompt);
+            ObjectGuid botGuid = bot->GetGUID();
 
-                if (g_EnableOllamaBotBuddyDebug)
-                {
-                    std::string safeJson = EscapeBracesForFmt(llmReply);
-                    LOG_INFO("server.loading", "[OllamaBotBuddy] LLM reply for '{}':\n{}", bot->GetName(), safeJson);
+            // Sent together with the other bots due within the batch window
+            if (IsBatchingEnabled())
+            {
+                if (pendingBatch.empty())
+                    pendingBatchSinceMs = now;
+                pendingBatch.push_back({ botGuid, botName, std::move(prompt), std::move(playerMessages) });
+                if (pendingBatch.size() >= g_OllamaBotControlBatchSize)
+                    FlushBotBatch(now);
+                continue;
+            }
 
-                }
+            bool session = g_OllamaBotControlSession;
+            std::string body;
+            if (session)
+            {
+                bool reset = false;
+                body = BuildBotSessionRequest(botGuid, GetBotRulesPrompt(), prompt, &reset);
 
-                if (!llmReply.empty())
+                // A fresh conversation never saw the state the delta refers to
+                if (reset && !keyframe)
                 {
-                    std::string jsonOnly = ExtractFirstJsonObject(llmReply);
-                    if (!jsonOnly.empty()) {
-                        SendBuddyBotStateToPlayer(bot, bot, prompt);
-                        ParseAndExecuteBotJson(bot, jsonOnly);
+                    // Same events, after the full state
+                    std::string events = prompt.substr(stateSize);
+                    promptBuffer.clear();
+                    RenderBotPromptKeyframe(promptBuffer, botGuid);
+                    promptBuffer.append(events.data(), events.data() + events.size());
+                    prompt = fmt::to_string(promptBuffer);
+                    body = BuildBotSessionRequest(botGuid, GetBotRulesPrompt(), prompt);
+                }
+            }
+            else
+                body = BuildOllamaGenerateBody(prompt + GetBotRulesPrompt(), GetBotDecisionFormat());
+            OllamaEndpoint endpoint = session ? OllamaEndpoint::Chat : OllamaEndpoint::Generate;
+
+            bool submitted = sOllamaHttpClient->Submit(endpoint, std::move(body), [botGuid, botName, prompt, session, playerMessages](OllamaResponse&& response) {
+                // Runs on the I/O thread, hand the reply over to a worker
+                bool queued = sOllamaWorkerPool->Enqueue([botGuid, botName, prompt, session, response = std::move(response)]() {
+                    BotReply reply;
+                    reply.botGuid = botGuid;
+                    reply.prompt = prompt;
+
+                    std::string llmReply = response.ok ? response.text : "";
+
+                    if (g_EnableOllamaBotBuddyDebug)
+                    {
+                        std::string safeJson = EscapeBracesForFmt(llmReply);
+                        LOG_INFO("server.loading", "[OllamaBotBuddy] LLM reply for '{}':\n{}", botName, safeJson);
 
-                    } else {
-                        LOG_ERROR("server.loading", "[OllamaBotBuddy] No valid JSON object found in LLM reply: {}", llmReply);
                     }
+
+                    if (!llmReply.empty())
+                    {
+                        BotStageTimer parseTimer(BotLatencyStage::Parse);
+                        std::string jsonOnly = response.json.empty() ? ExtractFirstJsonObject(llmReply) : response.json;
+                        if (!jsonOnly.empty()) {
+                            reply.parsed = ParseBotJson(jsonOnly, reply.decision);
+                            if (reply.parsed && session)
+                                RecordBotSessionTurn(botGuid, prompt, jsonOnly);
+                        } else {
+                            LOG_ERROR("server.loading", "[OllamaBotBuddy] No valid JSON object found in LLM reply: {}", llmReply);
+                            CountBotEvent(BotCounter::ParseErrors);
+                        }
+                    }
+
+                    botReplyMailbox.Enqueue(new BotReply(std::move(reply)));
+                });
+
+                // Still report back so the bot does not stay busy forever
+                if (!queued)
+                {
+                    RestorePlayerMessages(botGuid, playerMessages);
+                    BotReply reply;
+                    reply.botGuid = botGuid;
+                    botReplyMailbox.Enqueue(new BotReply(std::move(reply)));
                 }
+            });
 
-                // Mark ready for the next request
-                ollamaBotStates[guid].busy = false;
-            }).detach();
+            // Too many requests waiting, try again on a later update
+            if (!submitted)
+            {
+                // The delta was never sent, the next prompt must not build on it
+                ResetBotPromptDelta(botGuid);
+                RestorePlayerMessages(botGuid, playerMessages);
+                state.busy = false;
+                ScheduleBotDecision(dueGuid, now + BOT_RETRY_DELAY_MS);
+                if (g_EnableOllamaBotBuddyDebug)
+                    LOG_INFO("server.loading", "[OllamaBotBuddy] Request queue full, deferring decision for '{}'", botName);
+            }
         }
     }
+
+    if (!pendingBatch.empty() && now - pendingBatchSinceMs >= g_OllamaBotControlBatchWindowMs)
+        FlushBotBatch(now);
 }
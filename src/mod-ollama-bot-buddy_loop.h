@@ -1,18 +1,38 @@
 #pragma once
 #include "ScriptMgr.h"
+#include "mod-ollama-bot-buddy_api.h"
 #include <string>
+#include <string_view>
 
 class OllamaBotControlLoop : public WorldScript
 {
 public:
     OllamaBotControlLoop();
+    void OnStartup() override;
+    void OnShutdown() override;
     void OnUpdate(uint32 diff) override;
 };
 
+// A decision parsed from an LLM reply, ready to be applied on the world thread
+struct BotDecision
+{
+    BotControlCommand command;
+    std::string commandText;  // raw command object, kept for the history
+    std::string reasoning;
+    std::string say;
+};
+
+bool ParseBotJson(std::string_view jsonStr, BotDecision& decision);
+bool ExecuteBotDecision(Player* bot, const BotDecision& decision);
+// Forgets the request state of a bot that is no longer controlled
+void ResetOllamaBotState(ObjectGuid botGuid);
+
 void AddBotCommandHistory(Player* bot, const std::string& command);
 void AddBotReasoningHistory(Player* bot, const std::string& reasoning);
 
 std::vector<std::string> GetBotCommandHistory(Player* bot);
 std::vector<std::string> GetBotReasoningHistory(Player* bot);
+// Forgets the bot's commands, reasoning and unread player messages
+void ResetBotHistory(ObjectGuid botGuid);
 
 std::string EscapeBracesForFmt(const std::string& input);
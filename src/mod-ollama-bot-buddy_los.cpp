@@ -0,0 +1,86 @@
+#include "mod-ollama-bot-buddy_los.h"
+#include "mod-ollama-bot-buddy_config.h"
+#include "Player.h"
+#include "Timer.h"
+#include <atomic>
+#include <unordered_map>
+
+namespace
+{
+    struct LosCacheEntry
+    {
+        uint32 mapId;
+        Position botPos;
+        Position targetPos;
+        uint32 expiresAt;
+        bool result;
+    };
+
+    std::unordered_map<uint64, std::unordered_map<uint64, LosCacheEntry>> botLosCaches;
+
+    std::atomic<uint64> losCacheHits { 0 };
+    std::atomic<uint64> losCacheMisses { 0 };
+
+    bool HasMovedSince(Position const& before, WorldObject const* now, float threshold)
+    {
+        return before.GetExactDistSq(now) > threshold * threshold;
+    }
+}
+
+bool CachedIsWithinLOS(Player* bot, WorldObject const* target)
+{
+    if (!g_OllamaBotControlLosCacheTTL)
+        return bot->IsWithinLOS(target->GetPositionX(), target->GetPositionY(), target->GetPositionZ());
+
+    uint32 now = getMSTime();
+    auto& cache = botLosCaches[bot->GetGUID().GetRawValue()];
+    auto itr = cache.find(target->GetGUID().GetRawValue());
+    if (itr != cache.end())
+    {
+        LosCacheEntry const& entry = itr->second;
+        if (entry.mapId == bot->GetMapId() && int32(entry.expiresAt - now) > 0 &&
+            !HasMovedSince(entry.botPos, bot, g_OllamaBotControlLosCacheMoveThreshold) &&
+            !HasMovedSince(entry.targetPos, target, g_OllamaBotControlLosCacheMoveThreshold))
+        {
+            ++losCacheHits;
+            return entry.result;
+        }
+    }
+
+    ++losCacheMisses;
+    bool result = bot->IsWithinLOS(target->GetPositionX(), target->GetPositionY(), target->GetPositionZ());
+    cache[target->GetGUID().GetRawValue()] = { bot->GetMapId(), bot->GetPosition(), target->GetPosition(), now + g_OllamaBotControlLosCacheTTL, result };
+    return result;
+}
+
+void PruneBotLosCache(Player* bot)
+{
+    auto itr = botLosCaches.find(bot->GetGUID().GetRawValue());
+    if (itr == botLosCaches.end())
+        return;
+
+    uint32 now = getMSTime();
+    auto& cache = itr->second;
+    for (auto entry = cache.begin(); entry != cache.end();)
+    {
+        if (int32(entry->second.expiresAt - now) <= 0)
+            entry = cache.erase(entry);
+        else
+            ++entry;
+    }
+}
+
+void RemoveBotLosCache(ObjectGuid botGuid)
+{
+    botLosCaches.erase(botGuid.GetRawValue());
+}
+
+uint64 GetLosCacheHits()
+{
+    return losCacheHits.load();
+}
+
+uint64 GetLosCacheMisses()
+{
+    return losCacheMisses.load();
+}
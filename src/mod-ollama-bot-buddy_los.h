@@ -0,0 +1,18 @@
+#pragma once
+#include "ObjectGuid.h"
+
+class Player;
+class WorldObject;
+
+// Per-bot cache of line-of-sight results. A cached answer is reused until it
+// expires or until the bot or the target has moved further than the configured
+// threshold since the raycast, so idle bots almost never hit VMAP again.
+// World thread only.
+bool CachedIsWithinLOS(Player* bot, WorldObject const* target);
+
+// Drops expired entries of one bot, called once per prompt
+void PruneBotLosCache(Player* bot);
+void RemoveBotLosCache(ObjectGuid botGuid);
+
+uint64 GetLosCacheHits();
+uint64 GetLosCacheMisses();
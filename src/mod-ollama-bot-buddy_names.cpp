@@ -0,0 +1,145 @@
+#include "mod-ollama-bot-buddy_names.h"
+#include <algorithm>
+#include <cctype>
+#include <mutex>
+#include <queue>
+#include <shared_mutex>
+#include <unordered_map>
+
+void BotNameMatcher::Build(std::vector<Pattern> patterns)
+{
+    _patterns = std::move(patterns);
+    std::fill(std::begin(_alphabet), std::end(_alphabet), uint8(0));
+    _alphabetSize = 1;
+    for (Pattern const& pattern : _patterns)
+        for (char c : pattern.name)
+            if (!_alphabet[uint8(c)] && _alphabetSize < 256)
+                _alphabet[uint8(c)] = uint8(_alphabetSize++);
+
+    // Trie, -1 marks a missing edge until the failure links fill it in
+    _transitions.assign(_alphabetSize, -1);
+    _outputs.assign(1, {});
+    for (uint32 i = 0; i < _patterns.size(); ++i)
+    {
+        int32 state = 0;
+        for (char c : _patterns[i].name)
+        {
+            size_t edge = size_t(state) * _alphabetSize + _alphabet[uint8(c)];
+            if (_transitions[edge] < 0)
+            {
+                _transitions[edge] = int32(_outputs.size());
+                _outputs.emplace_back();
+                _transitions.resize(_transitions.size() + _alphabetSize, -1);
+            }
+            state = _transitions[edge];
+        }
+        _outputs[state].push_back(i);
+    }
+
+    // Breadth-first pass turning the trie into a DFA. Symbol 0 never starts a name.
+    std::vector<int32> fail(_outputs.size(), 0);
+    std::queue<int32> queue;
+    for (uint32 symbol = 0; symbol < _alphabetSize; ++symbol)
+    {
+        int32& target = _transitions[symbol];
+        if (target < 0)
+            target = 0;
+        else
+            queue.push(target);
+    }
+
+    while (!queue.empty())
+    {
+        int32 state = queue.front();
+        queue.pop();
+        std::vector<uint32> const& inherited = _outputs[fail[state]];
+        _outputs[state].insert(_outputs[state].end(), inherited.begin(), inherited.end());
+
+        for (uint32 symbol = 0; symbol < _alphabetSize; ++symbol)
+        {
+            int32& target = _transitions[size_t(state) * _alphabetSize + symbol];
+            int32 fallback = _transitions[size_t(fail[state]) * _alphabetSize + symbol];
+            if (target < 0)
+                target = fallback;
+            else
+            {
+                fail[target] = fallback;
+                queue.push(target);
+            }
+        }
+    }
+}
+
+void BotNameMatcher::Match(std::string_view message, std::vector<ObjectGuid>& matches) const
+{
+    if (_patterns.empty())
+        return;
+
+    size_t first = matches.size();
+    int32 state = 0;
+    for (char c : message)
+    {
+        state = Next(state, uint8(c));
+        for (uint32 pattern : _outputs[state])
+            matches.push_back(_patterns[pattern].guid);
+    }
+
+    // A name mentioned twice still only records the message once
+    std::sort(matches.begin() + first, matches.end());
+    matches.erase(std::unique(matches.begin() + first, matches.end()), matches.end());
+}
+
+std::string ToLowerBotName(std::string_view name)
+{
+    std::string lower(name);
+    std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+    return lower;
+}
+
+namespace
+{
+    std::unordered_map<uint64, std::string> botNames;
+    BotNameMatcher botNameMatcher;
+    bool botNameMatcherDirty = false;
+    std::shared_mutex botNamesMutex;
+}
+
+void RegisterBotName(ObjectGuid guid, std::string const& name)
+{
+    if (name.empty())
+        return;
+    std::unique_lock<std::shared_mutex> lock(botNamesMutex);
+    botNames[guid.GetRawValue()] = ToLowerBotName(name);
+    botNameMatcherDirty = true;
+}
+
+void UnregisterBotName(ObjectGuid guid)
+{
+    std::unique_lock<std::shared_mutex> lock(botNamesMutex);
+    if (botNames.erase(guid.GetRawValue()))
+        botNameMatcherDirty = true;
+}
+
+void FindMentionedBots(std::string_view lowerMessage, std::vector<ObjectGuid>& matches)
+{
+    {
+        std::shared_lock<std::shared_mutex> lock(botNamesMutex);
+        if (!botNameMatcherDirty)
+        {
+            botNameMatcher.Match(lowerMessage, matches);
+            return;
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> lock(botNamesMutex);
+    if (botNameMatcherDirty)
+    {
+        std::vector<BotNameMatcher::Pattern> patterns;
+        patterns.reserve(botNames.size());
+        for (auto const& [guid, name] : botNames)
+            patterns.push_back({ name, ObjectGuid(guid) });
+        botNameMatcher.Build(std::move(patterns));
+        botNameMatcherDirty = false;
+    }
+    botNameMatcher.Match(lowerMessage, matches);
+}
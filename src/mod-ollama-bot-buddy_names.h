@@ -0,0 +1,44 @@
+#pragma once
+#include "ObjectGuid.h"
+#include <string>
+#include <string_view>
+#include <vector>
+
+class Player;
+
+// Aho-Corasick automaton over lowercased bot names. A single pass over a
+// message reports every name it contains, however many bots are registered.
+class BotNameMatcher
+{
+public:
+    struct Pattern
+    {
+        std::string name;  // lowercased
+        ObjectGuid guid;
+    };
+
+    void Build(std::vector<Pattern> patterns);
+
+    // message must already be lowercased, each matching guid is reported once
+    void Match(std::string_view message, std::vector<ObjectGuid>& matches) const;
+
+    size_t GetPatternCount() const { return _patterns.size(); }
+
+private:
+    int32 Next(int32 state, uint8 c) const { return _transitions[size_t(state) * _alphabetSize + _alphabet[c]]; }
+
+    std::vector<Pattern> _patterns;
+    uint8 _alphabet[256] = {};                // byte -> symbol, 0 for bytes that appear in no name
+    uint32 _alphabetSize = 1;
+    std::vector<int32> _transitions;           // full DFA, state * alphabetSize + symbol
+    std::vector<std::vector<uint32>> _outputs; // patterns ending at each state, fail chain included
+};
+
+std::string ToLowerBotName(std::string_view name);
+
+// Registry of the names chat is matched against. Login/logout only mark the
+// automaton dirty, it is rebuilt once on the next chat line so a wave of bot
+// logins costs a single build. Safe to call from any thread.
+void RegisterBotName(ObjectGuid guid, std::string const& name);
+void UnregisterBotName(ObjectGuid guid);
+void FindMentionedBots(std::string_view lowerMessage, std::vector<ObjectGuid>& matches);
@@ -0,0 +1,240 @@
+#include "mod-ollama-bot-buddy_prompt.h"
+#include "mod-ollama-bot-buddy_config.h"
+#include "StringFormat.h"
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <string_view>
+#include <unordered_map>
+
+namespace
+{
+    struct BotPromptHistory
+    {
+        BotPromptSnapshot last;
+        uint32 sinceKeyframe = 0;
+        bool valid = false;
+    };
+
+    std::unordered_map<uint64, BotPromptHistory> botPromptHistory;
+
+    std::atomic<uint64> truncatedSections { 0 };
+    std::atomic<uint64> droppedEntries { 0 };
+
+    uint64 deltaPrompts = 0;
+    uint64 keyframePrompts = 0;
+
+    void AppendPromptLine(PromptBuffer& out, std::string_view prefix, std::string_view text)
+    {
+        out.append(prefix.data(), prefix.data() + prefix.size());
+        out.append(text.data(), text.data() + text.size());
+        out.push_back('\n');
+    }
+
+    struct PromptEntryRef
+    {
+        std::string_view key;
+        std::string_view text;
+        bool matched;
+    };
+
+    // Entries of the previous section sorted by key, reused by every delta. World thread only.
+    std::vector<PromptEntryRef> previousEntries;
+
+    PromptEntryRef* FindPreviousEntry(std::string_view key)
+    {
+        auto itr = std::lower_bound(previousEntries.begin(), previousEntries.end(), key,
+            [](PromptEntryRef const& entry, std::string_view k) { return entry.key < k; });
+        return itr != previousEntries.end() && itr->key == key ? &*itr : nullptr;
+    }
+
+    void AppendSectionDelta(PromptBuffer& out, PromptSection const* previous, PromptSection const* current)
+    {
+        previousEntries.clear();
+        if (previous)
+        {
+            for (PromptEntry const& entry : previous->entries)
+                previousEntries.push_back({ entry.key, entry.text, false });
+            std::sort(previousEntries.begin(), previousEntries.end(),
+                [](PromptEntryRef const& a, PromptEntryRef const& b) { return a.key < b.key; });
+        }
+
+        // The title goes first and is taken back if nothing in the section changed
+        PromptSection const* section = current ? current : previous;
+        size_t start = out.size();
+        if (section->title.empty())
+            fmt::format_to(std::back_inserter(out), "{}:\n", section->name);
+        else
+            AppendPromptLine(out, "", section->title);
+        size_t header = out.size();
+
+        if (current)
+        {
+            for (PromptEntry const& entry : current->entries)
+            {
+                PromptEntryRef* before = FindPreviousEntry(entry.key);
+                if (!before || before->matched)
+                    AppendPromptLine(out, " + ", entry.text);
+                else
+                {
+                    if (before->text != entry.text)
+                        AppendPromptLine(out, " ~ ", entry.text);
+                    before->matched = true;
+                }
+            }
+        }
+
+        // Whatever is left was not in the current snapshot
+        if (previous)
+            for (PromptEntry const& entry : previous->entries)
+                if (!FindPreviousEntry(entry.key)->matched)
+                    AppendPromptLine(out, " - ", entry.text);
+
+        if (out.size() == header)
+            out.resize(start);
+    }
+}
+
+PromptBuffer& GetBotPromptBuffer()
+{
+    static PromptBuffer buffer;
+    buffer.clear();
+    return buffer;
+}
+
+void RenderPromptSnapshot(PromptBuffer& out, BotPromptSnapshot const& snapshot)
+{
+    for (PromptSection const& section : snapshot)
+    {
+        if (section.entries.empty())
+            continue;
+
+        if (!section.title.empty())
+            AppendPromptLine(out, "", section.title);
+        for (PromptEntry const& entry : section.entries)
+            AppendPromptLine(out, section.bullet, entry.text);
+        if (section.blankLineAfter)
+            out.push_back('\n');
+    }
+}
+
+size_t FitPromptSection(PromptSection& section, uint32 budgetTokens)
+{
+    std::vector<PromptEntry>& entries = section.entries;
+    if (!budgetTokens || entries.empty())
+        return 0;
+
+    size_t bulletChars = section.bullet.size() + 1;
+    size_t totalChars = 0;
+    for (PromptEntry const& entry : entries)
+        totalChars += entry.text.size() + bulletChars;
+    if (EstimatePromptTokens(totalChars) <= budgetTokens)
+        return 0;
+
+    // Only the entries that can possibly fit are ordered, the rest of the crowd is never sorted
+    size_t averageChars = totalChars / entries.size();
+    size_t candidates = std::min(entries.size(), size_t(budgetTokens) * 4 / std::max<size_t>(averageChars, 1) + 1);
+    auto byRelevance = [](PromptEntry const& a, PromptEntry const& b) { return a.relevance > b.relevance; };
+    std::partial_sort(entries.begin(), entries.begin() + candidates, entries.end(), byRelevance);
+
+    size_t kept = 0;
+    size_t usedChars = 0;
+    while (kept < candidates && EstimatePromptTokens(usedChars + entries[kept].text.size() + bulletChars) <= budgetTokens)
+        usedChars += entries[kept++].text.size() + bulletChars;
+
+    size_t dropped = entries.size() - kept;
+    entries.resize(kept);
+    entries.push_back({ "dropped", Acore::StringFormat("... and {} more not listed", dropped) });
+
+    ++truncatedSections;
+    droppedEntries += dropped;
+    return dropped;
+}
+
+uint64 GetTruncatedSectionCount()
+{
+    return truncatedSections.load();
+}
+
+uint64 GetDroppedEntryCount()
+{
+    return droppedEntries.load();
+}
+
+bool IsDeltaPromptEnabled()
+{
+    // A delta only makes sense to a conversation that saw the previous state
+    return g_OllamaBotControlDeltaPrompts && g_OllamaBotControlSession;
+}
+
+void BuildBotDeltaPrompt(PromptBuffer& out, ObjectGuid botGuid, BotPromptSnapshot snapshot, bool& keyframe)
+{
+    BotPromptHistory& history = botPromptHistory[botGuid.GetRawValue()];
+
+    keyframe = !history.valid || history.sinceKeyframe >= g_OllamaBotControlDeltaKeyframeInterval;
+    if (keyframe)
+    {
+        RenderPromptSnapshot(out, snapshot);
+        history.sinceKeyframe = 0;
+        ++keyframePrompts;
+    }
+    else
+    {
+        constexpr std::string_view changesHeader = "Changes since your previous update (+ new, ~ changed, - gone). Anything not listed is unchanged.\n";
+        constexpr std::string_view nothingChanged = "Nothing changed since your previous update.\n";
+
+        size_t start = out.size();
+        out.append(changesHeader.data(), changesHeader.data() + changesHeader.size());
+        size_t header = out.size();
+
+        // A handful of sections, found by name without building a lookup
+        auto findSection = [](BotPromptSnapshot const& sections, std::string const& name) -> PromptSection const* {
+            auto itr = std::find_if(sections.begin(), sections.end(), [&name](PromptSection const& section) { return section.name == name; });
+            return itr != sections.end() ? &*itr : nullptr;
+        };
+
+        for (PromptSection const& section : snapshot)
+            AppendSectionDelta(out, findSection(history.last, section.name), &section);
+        for (PromptSection const& section : history.last)
+            if (!findSection(snapshot, section.name))
+                AppendSectionDelta(out, &section, nullptr);
+
+        if (out.size() == header)
+        {
+            out.resize(start);
+            out.append(nothingChanged.data(), nothingChanged.data() + nothingChanged.size());
+        }
+
+        ++history.sinceKeyframe;
+        ++deltaPrompts;
+    }
+
+    history.last = std::move(snapshot);
+    history.valid = true;
+}
+
+void RenderBotPromptKeyframe(PromptBuffer& out, ObjectGuid botGuid)
+{
+    auto itr = botPromptHistory.find(botGuid.GetRawValue());
+    if (itr == botPromptHistory.end())
+        return;
+
+    itr->second.sinceKeyframe = 0;
+    ++keyframePrompts;
+    RenderPromptSnapshot(out, itr->second.last);
+}
+
+void ResetBotPromptDelta(ObjectGuid botGuid)
+{
+    botPromptHistory.erase(botGuid.GetRawValue());
+}
+
+uint64 GetDeltaPromptCount()
+{
+    return deltaPrompts;
+}
+
+uint64 GetKeyframePromptCount()
+{
+    return keyframePrompts;
+}
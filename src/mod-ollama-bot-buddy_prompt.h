@@ -0,0 +1,64 @@
+#pragma once
+#include "ObjectGuid.h"
+#include <fmt/format.h>
+#include <string>
+#include <vector>
+
+// One line of the bot state. The key identifies what the line describes
+// (a stat, a creature GUID, a quest...) so two snapshots can be compared.
+struct PromptEntry
+{
+    std::string key;
+    std::string text;
+    float relevance = 0.0f;  // higher is kept first when the section is over budget
+};
+
+struct PromptSection
+{
+    std::string name;    // stable id, used to diff snapshots
+    std::string title;   // header line, omitted when empty
+    std::string bullet;  // prefix of every entry line
+    std::vector<PromptEntry> entries;
+    bool blankLineAfter = false;
+};
+
+using BotPromptSnapshot = std::vector<PromptSection>;
+
+// Prompt text is written straight into this with fmt::format_to, the
+// std::string sent to Ollama is made once the whole prompt is in it
+using PromptBuffer = fmt::memory_buffer;
+
+// Prompts are built one at a time on the world thread, so they all share one
+// buffer that keeps the capacity of the largest prompt so far. Returned empty.
+PromptBuffer& GetBotPromptBuffer();
+
+void RenderPromptSnapshot(PromptBuffer& out, BotPromptSnapshot const& snapshot);
+
+// Rough estimate, good enough to stay clear of the context window
+inline size_t EstimatePromptTokens(size_t chars)
+{
+    return chars / 4;
+}
+
+// Keeps the most relevant entries of the section that fit in budgetTokens,
+// ordered by relevance, and appends a line telling how many were left out.
+// Returns the number of dropped entries. A budget of 0 means unlimited.
+size_t FitPromptSection(PromptSection& section, uint32 budgetTokens);
+
+// Delta mode keeps the last snapshot sent to each bot's session and only
+// renders what was added, changed or removed since, with a full keyframe
+// every OllamaBotControl.DeltaKeyframeInterval decisions. World thread only.
+bool IsDeltaPromptEnabled();
+void BuildBotDeltaPrompt(PromptBuffer& out, ObjectGuid botGuid, BotPromptSnapshot snapshot, bool& keyframe);
+
+// Full render of the last snapshot, for a conversation that had to start over
+void RenderBotPromptKeyframe(PromptBuffer& out, ObjectGuid botGuid);
+
+// The model did not see the last prompt, the next one must be a keyframe
+void ResetBotPromptDelta(ObjectGuid botGuid);
+
+uint64 GetTruncatedSectionCount();
+uint64 GetDroppedEntryCount();
+
+uint64 GetDeltaPromptCount();
+uint64 GetKeyframePromptCount();
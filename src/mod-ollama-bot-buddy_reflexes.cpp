@@ -0,0 +1,224 @@
+#include "mod-ollama-bot-buddy_reflexes.h"
+#include "mod-ollama-bot-buddy_api.h"
+#include "mod-ollama-bot-buddy_config.h"
+#include "mod-ollama-bot-buddy_targets.h"
+#include "Creature.h"
+#include "Log.h"
+#include "MotionMaster.h"
+#include "Player.h"
+#include "PlayerbotAI.h"
+#include "PlayerbotMgr.h"
+#include "Tokenize.h"
+#include <unordered_map>
+
+namespace
+{
+    struct BotReflex
+    {
+        std::string name;
+        BotReflexRule rule;
+        bool enabled = false;
+        uint64 fired = 0;
+    };
+
+    struct LastReflex
+    {
+        size_t reflex;
+        uint64 target;
+    };
+
+    std::vector<BotReflex> reflexes;
+    std::vector<size_t> enabledReflexes;  // indexes into reflexes, in configured order
+    std::unordered_map<uint64, LastReflex> lastReflexes;
+
+    // Fights back against the nearest attacker when the bot has no target of its own
+    bool AttackedReflex(Player* bot, BotDecision& decision, uint64& target)
+    {
+        if (bot->GetVictim())
+            return false;
+
+        Unit* nearest = nullptr;
+        float nearestDist = 0.0f;
+        for (Unit* attacker : bot->getAttackers())
+        {
+            if (!attacker->IsAlive() || !attacker->IsInWorld())
+                continue;
+            float dist = bot->GetDistance(attacker);
+            if (!nearest || dist < nearestDist)
+            {
+                nearest = attacker;
+                nearestDist = dist;
+            }
+        }
+        if (!nearest)
+            return false;
+
+        target = nearest->GetGUID().GetRawValue();
+        decision.command = AttackCommand{ nearest->GetGUID().GetCounter() };
+        decision.reasoning = "Attacked by " + nearest->GetName() + ", fighting back.";
+        return true;
+    }
+
+    // Loots a corpse from the bot's last snapshot that is already within reach
+    bool LootReflex(Player* bot, BotDecision& decision, uint64& target)
+    {
+        if (bot->IsInCombat())
+            return false;
+
+        for (Creature* creature : GetIndexedBotCreatures(bot))
+        {
+            if (!creature->isDead() || !creature->HasFlag(UNIT_DYNAMIC_FLAGS, UNIT_DYNFLAG_LOOTABLE))
+                continue;
+            if (!bot->IsWithinDistInMap(creature, INTERACTION_DISTANCE))
+                continue;
+
+            target = creature->GetGUID().GetRawValue();
+            decision.command = LootCommand{};
+            decision.reasoning = "Looting " + creature->GetName() + " next to me.";
+            return true;
+        }
+        return false;
+    }
+
+    // Catches up with the master once it is further away than OllamaBotControl.ReflexFollowDistance
+    bool FollowReflex(Player* bot, BotDecision& decision, uint64& target)
+    {
+        if (bot->IsInCombat())
+            return false;
+
+        PlayerbotAI* ai = sPlayerbotsMgr->GetPlayerbotAI(bot);
+        Player* master = ai ? ai->GetMaster() : nullptr;
+        if (!master || master == bot || !master->IsInWorld() || master->GetMap() != bot->GetMap())
+            return false;
+
+        if (bot->GetMotionMaster()->GetCurrentMovementGeneratorType() == FOLLOW_MOTION_TYPE)
+            return false;
+        if (bot->IsWithinDistInMap(master, g_OllamaBotControlReflexFollowDistance))
+            return false;
+
+        target = master->GetGUID().GetRawValue();
+        decision.command = FollowCommand{};
+        decision.reasoning = master->GetName() + " is far away, following.";
+        return true;
+    }
+
+    void RegisterBuiltinBotReflexes()
+    {
+        if (!reflexes.empty())
+            return;
+
+        RegisterBotReflex("attacked", AttackedReflex);
+        RegisterBotReflex("loot", LootReflex);
+        RegisterBotReflex("follow", FollowReflex);
+    }
+}
+
+void RegisterBotReflex(std::string name, BotReflexRule rule)
+{
+    for (BotReflex& reflex : reflexes)
+    {
+        if (reflex.name == name)
+        {
+            reflex.rule = std::move(rule);
+            return;
+        }
+    }
+
+    BotReflex reflex;
+    reflex.name = std::move(name);
+    reflex.rule = std::move(rule);
+    reflexes.push_back(std::move(reflex));
+}
+
+void LoadBotReflexConfig()
+{
+    RegisterBuiltinBotReflexes();
+
+    enabledReflexes.clear();
+    lastReflexes.clear();
+    for (BotReflex& reflex : reflexes)
+        reflex.enabled = false;
+
+    for (std::string_view name : Acore::Tokenize(g_OllamaBotControlReflexes, ',', false))
+    {
+        while (!name.empty() && name.front() == ' ')
+            name.remove_prefix(1);
+        while (!name.empty() && name.back() == ' ')
+            name.remove_suffix(1);
+        if (name.empty())
+            continue;
+
+        bool found = false;
+        for (size_t i = 0; i < reflexes.size(); ++i)
+        {
+            if (reflexes[i].name != name)
+                continue;
+            found = true;
+            if (!reflexes[i].enabled)
+            {
+                reflexes[i].enabled = true;
+                enabledReflexes.push_back(i);
+            }
+        }
+
+        if (!found)
+            LOG_ERROR("server.loading", "[OllamaBotBuddy] Ignoring unknown reflex '{}' in OllamaBotControl.Reflexes", name);
+    }
+}
+
+bool RunBotReflexes(Player* bot)
+{
+    uint64 botGuid = bot->GetGUID().GetRawValue();
+    auto lastItr = lastReflexes.find(botGuid);
+
+    for (size_t index : enabledReflexes)
+    {
+        BotReflex& reflex = reflexes[index];
+
+        BotDecision decision;
+        uint64 target = 0;
+        if (!reflex.rule(bot, decision, target))
+            continue;
+
+        // Did not help the first time, let the LLM look at it
+        if (lastItr != lastReflexes.end() && lastItr->second.reflex == index && lastItr->second.target == target)
+            continue;
+
+        // Only a command that went through is worth remembering, a failed one falls through to the next rule
+        if (!HandleBotControlCommand(bot, decision.command))
+            continue;
+        AddBotReasoningHistory(bot, decision.reasoning);
+        AddBotCommandHistory(bot, FormatCommandString(decision.command));
+
+        ++reflex.fired;
+        lastReflexes[botGuid] = { index, target };
+
+        if (g_EnableOllamaBotBuddyDebug)
+            LOG_INFO("server.loading", "[OllamaBotBuddy] Reflex '{}' for '{}': {}", reflex.name, bot->GetName(), decision.reasoning);
+        return true;
+    }
+
+    // The LLM decides this time, the next reflex may react to anything again
+    if (lastItr != lastReflexes.end())
+        lastReflexes.erase(lastItr);
+    return false;
+}
+
+void ResetBotReflexes(ObjectGuid botGuid)
+{
+    lastReflexes.erase(botGuid.GetRawValue());
+}
+
+bool HasEnabledBotReflexes()
+{
+    return !enabledReflexes.empty();
+}
+
+std::vector<BotReflexStats> GetBotReflexStats()
+{
+    std::vector<BotReflexStats> stats;
+    stats.reserve(reflexes.size());
+    for (BotReflex const& reflex : reflexes)
+        stats.push_back({ reflex.name, reflex.enabled, reflex.fired });
+    return stats;
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include "mod-ollama-bot-buddy_loop.h"
+#include <functional>
+#include <string>
+#include <vector>
+
+class Player;
+
+// Local rules for decisions that need no language model: fighting back when
+// attacked, looting a corpse in reach, following a master that wandered off.
+// They run on every due bot, also one still waiting for the LLM, before its
+// snapshot is collected, and a rule that fires replaces the LLM call. World
+// thread only.
+//
+// A rule fills in the decision and the target it reacted to. The same rule
+// never fires twice in a row on the same target, so a reflex that did not
+// change anything hands the next decision back to the LLM.
+using BotReflexRule = std::function<bool(Player* bot, BotDecision& decision, uint64& target)>;
+
+struct BotReflexStats
+{
+    std::string name;
+    bool enabled;
+    uint64 fired;  // LLM calls saved
+};
+
+// Adds a rule that OllamaBotControl.Reflexes can enable by name
+void RegisterBotReflex(std::string name, BotReflexRule rule);
+// Enables the rules listed in OllamaBotControl.Reflexes, evaluated in that order
+void LoadBotReflexConfig();
+
+// Executes the first enabled rule that fires for the bot, returns false if the LLM has to decide
+bool RunBotReflexes(Player* bot);
+void ResetBotReflexes(ObjectGuid botGuid);
+
+bool HasEnabledBotReflexes();
+std::vector<BotReflexStats> GetBotReflexStats();
@@ -0,0 +1,219 @@
+#include "mod-ollama-bot-buddy_registry.h"
+#include "mod-ollama-bot-buddy_config.h"
+#include "mod-ollama-bot-buddy_loop.h"
+#include "mod-ollama-bot-buddy_los.h"
+#include "mod-ollama-bot-buddy_names.h"
+#include "mod-ollama-bot-buddy_prompt.h"
+#include "mod-ollama-bot-buddy_reflexes.h"
+#include "mod-ollama-bot-buddy_scheduler.h"
+#include "mod-ollama-bot-buddy_session.h"
+#include "mod-ollama-bot-buddy_spells.h"
+#include "mod-ollama-bot-buddy_targets.h"
+#include "AccountMgr.h"
+#include "Log.h"
+#include "Player.h"
+#include "PlayerbotAI.h"
+#include "PlayerbotMgr.h"
+#include "RandomPlayerbotMgr.h"
+#include "StringConvert.h"
+#include "Tokenize.h"
+#include "WorldSession.h"
+#include <cctype>
+#include <string>
+#include <unordered_set>
+
+namespace
+{
+    std::unordered_map<uint64, ControlledBot> controlledBots;
+
+    std::unordered_set<std::string> configuredNames;    // lowercased
+    std::unordered_set<uint32> configuredGuids;         // low GUIDs
+    std::string configuredAccountPattern;               // lowercased, '*' matches anything
+    std::unordered_map<uint32, bool> accountMatches;    // account id -> matches the pattern
+
+    std::string_view Trim(std::string_view value)
+    {
+        while (!value.empty() && std::isspace(uint8(value.front())))
+            value.remove_prefix(1);
+        while (!value.empty() && std::isspace(uint8(value.back())))
+            value.remove_suffix(1);
+        return value;
+    }
+
+    bool MatchesWildcard(std::string_view pattern, std::string_view text)
+    {
+        size_t p = 0, t = 0, star = std::string_view::npos, resume = 0;
+        while (t < text.size())
+        {
+            if (p < pattern.size() && pattern[p] == '*')
+            {
+                star = p++;
+                resume = t;
+            }
+            else if (p < pattern.size() && pattern[p] == text[t])
+            {
+                ++p;
+                ++t;
+            }
+            else if (star != std::string_view::npos)
+            {
+                p = star + 1;
+                t = ++resume;
+            }
+            else
+                return false;
+        }
+        while (p < pattern.size() && pattern[p] == '*')
+            ++p;
+        return p == pattern.size();
+    }
+
+    bool MatchesAccountPattern(Player* player)
+    {
+        if (configuredAccountPattern.empty())
+            return false;
+
+        // Bots share a handful of accounts, each is looked up once
+        uint32 accountId = player->GetSession()->GetAccountId();
+        auto itr = accountMatches.find(accountId);
+        if (itr != accountMatches.end())
+            return itr->second;
+
+        std::string accountName;
+        bool matches = AccountMgr::GetName(accountId, accountName) && MatchesWildcard(configuredAccountPattern, ToLowerBotName(accountName));
+        accountMatches[accountId] = matches;
+        return matches;
+    }
+
+    // Stable across restarts, so the same random bots stay controlled
+    bool InRandomBotShare(Player* player)
+    {
+        if (!g_OllamaBotControlRandomBotPercent || !sRandomPlayerbotMgr->IsRandomBot(player))
+            return false;
+        return (player->GetGUID().GetCounter() * 2654435761u) % 100 < g_OllamaBotControlRandomBotPercent;
+    }
+
+    // Drops everything kept for a bot while it was controlled, so a bot taken
+    // over again starts from a clean slate and a released one leaks nothing
+    void ForgetControlledBot(ObjectGuid guid)
+    {
+        UnregisterBotName(guid);
+        UnscheduleBotDecision(guid);
+        ResetBotReflexes(guid);
+        RemoveBotLosCache(guid);
+        RemoveBotTargetIndex(guid);
+        RemoveBotSpellSummary(guid);
+        ResetBotSession(guid);
+        ResetBotPromptDelta(guid);
+        ResetOllamaBotState(guid);
+        ResetBotHistory(guid);
+    }
+}
+
+void LoadControlledBotConfig()
+{
+    configuredNames.clear();
+    configuredGuids.clear();
+    accountMatches.clear();
+
+    for (std::string_view name : Acore::Tokenize(g_OllamaBotControlControlledBotNames, ',', false))
+    {
+        name = Trim(name);
+        if (!name.empty())
+            configuredNames.insert(ToLowerBotName(name));
+    }
+
+    for (std::string_view guid : Acore::Tokenize(g_OllamaBotControlControlledBotGuids, ',', false))
+    {
+        guid = Trim(guid);
+        if (guid.empty())
+            continue;
+        if (Optional<uint32> lowGuid = Acore::StringTo<uint32>(guid))
+            configuredGuids.insert(*lowGuid);
+        else
+            LOG_ERROR("server.loading", "[OllamaBotBuddy] Ignoring invalid GUID '{}' in OllamaBotControl.ControlledBotGuids", guid);
+    }
+
+    configuredAccountPattern = ToLowerBotName(Trim(g_OllamaBotControlControlledBotAccountPattern));
+
+    LOG_INFO("server.loading", "[OllamaBotBuddy] Controlling bots by {} names, {} GUIDs, account pattern '{}', {}% of random bots",
+        configuredNames.size(), configuredGuids.size(), configuredAccountPattern, g_OllamaBotControlRandomBotPercent);
+}
+
+void CheckControlledBotLogin(Player* player)
+{
+    if (configuredNames.count(ToLowerBotName(player->GetName())) ||
+        configuredGuids.count(player->GetGUID().GetCounter()) ||
+        MatchesAccountPattern(player) ||
+        InRandomBotShare(player))
+        AddControlledBot(player);
+}
+
+void AddControlledBot(Player* bot)
+{
+    auto [itr, inserted] = controlledBots.try_emplace(bot->GetGUID().GetRawValue());
+    if (!inserted)
+        return;
+
+    itr->second.guid = bot->GetGUID();
+    RegisterBotName(bot->GetGUID(), bot->GetName());
+    ScheduleBotDecision(bot->GetGUID(), 0);
+
+    if (g_EnableOllamaBotBuddyDebug)
+        LOG_INFO("server.loading", "[OllamaBotBuddy] Bot '{}' is now LLM-controlled", bot->GetName());
+}
+
+bool ReleaseControlledBot(Player* bot)
+{
+    auto itr = controlledBots.find(bot->GetGUID().GetRawValue());
+    if (itr == controlledBots.end())
+        return false;
+
+    if (itr->second.takenOver)
+        if (PlayerbotAI* ai = sPlayerbotsMgr->GetPlayerbotAI(bot))
+            ai->ResetStrategies();
+
+    controlledBots.erase(itr);
+    ForgetControlledBot(bot->GetGUID());
+    return true;
+}
+
+void RemoveControlledBot(ObjectGuid guid)
+{
+    if (controlledBots.erase(guid.GetRawValue()))
+        ForgetControlledBot(guid);
+}
+
+bool IsControlledBot(ObjectGuid guid)
+{
+    return controlledBots.count(guid.GetRawValue()) != 0;
+}
+
+bool TakeOverControlledBot(Player* bot, ControlledBot& entry)
+{
+    if (entry.takenOver)
+        return true;
+
+    // Playerbots creates the AI after the login hooks, so takeover waits for it
+    PlayerbotAI* ai = sPlayerbotsMgr->GetPlayerbotAI(bot);
+    if (!ai || !ai->IsBotAI())
+        return false;
+
+    // Clear the normal Playerbot AI
+    ai->ClearStrategies(BOT_STATE_COMBAT);
+    ai->ClearStrategies(BOT_STATE_NON_COMBAT);
+    ai->ClearStrategies(BOT_STATE_DEAD);
+    entry.takenOver = true;
+    return true;
+}
+
+ControlledBot* FindControlledBot(ObjectGuid guid)
+{
+    auto itr = controlledBots.find(guid.GetRawValue());
+    return itr != controlledBots.end() ? &itr->second : nullptr;
+}
+
+std::unordered_map<uint64, ControlledBot>& GetControlledBots()
+{
+    return controlledBots;
+}
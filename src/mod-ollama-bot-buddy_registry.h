@@ -0,0 +1,32 @@
+#pragma once
+#include "ObjectGuid.h"
+#include <unordered_map>
+
+class Player;
+
+struct ControlledBot
+{
+    ObjectGuid guid;
+    bool takenOver = false;  // normal Playerbot strategies have been cleared
+};
+
+// Bots handed over to the LLM. Filled from the configured lists when a bot
+// logs in and by the .buddy GM commands, so the world update only ever
+// touches the bots it controls. World thread only.
+void LoadControlledBotConfig();
+
+// Adds the bot if it matches the configured names, GUIDs, account pattern or random bot share
+void CheckControlledBotLogin(Player* player);
+
+void AddControlledBot(Player* bot);
+// Gives the bot back to its normal Playerbot strategies, returns false if it was not controlled
+bool ReleaseControlledBot(Player* bot);
+void RemoveControlledBot(ObjectGuid guid);
+bool IsControlledBot(ObjectGuid guid);
+ControlledBot* FindControlledBot(ObjectGuid guid);
+
+// Clears the bot's Playerbot strategies the first time its AI is available,
+// returns false while the bot cannot be controlled yet
+bool TakeOverControlledBot(Player* bot, ControlledBot& entry);
+
+std::unordered_map<uint64, ControlledBot>& GetControlledBots();
@@ -0,0 +1,97 @@
+#include "mod-ollama-bot-buddy_scheduler.h"
+#include "mod-ollama-bot-buddy_config.h"
+#include "MotionMaster.h"
+#include "MPSCQueue.h"
+#include "Player.h"
+#include <functional>
+#include <memory>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+    struct ScheduledDecision
+    {
+        uint64 dueMs;
+        uint64 botGuid;
+        uint32 generation;
+
+        bool operator>(ScheduledDecision const& other) const { return dueMs > other.dueMs; }
+    };
+
+    std::priority_queue<ScheduledDecision, std::vector<ScheduledDecision>, std::greater<ScheduledDecision>> decisionHeap;
+
+    // Generation of the live heap entry of each scheduled bot
+    std::unordered_map<uint64, uint32> scheduledBots;
+    uint32 nextGeneration = 0;
+
+    // Filled by combat hooks that may run on map threads
+    MPSCQueue<ObjectGuid> wakeMailbox;
+}
+
+void ScheduleBotDecision(ObjectGuid botGuid, uint64 dueMs)
+{
+    uint32 generation = ++nextGeneration;
+    scheduledBots[botGuid.GetRawValue()] = generation;
+    decisionHeap.push({ dueMs, botGuid.GetRawValue(), generation });
+}
+
+void UnscheduleBotDecision(ObjectGuid botGuid)
+{
+    scheduledBots.erase(botGuid.GetRawValue());
+}
+
+void WakeBotDecision(ObjectGuid botGuid)
+{
+    wakeMailbox.Enqueue(new ObjectGuid(botGuid));
+}
+
+bool PopDueBotDecision(uint64 nowMs, ObjectGuid& botGuid)
+{
+    ObjectGuid* woken = nullptr;
+    while (wakeMailbox.Dequeue(woken))
+    {
+        std::unique_ptr<ObjectGuid> owned(woken);
+        if (scheduledBots.count(owned->GetRawValue()))
+            ScheduleBotDecision(*owned, nowMs);
+    }
+
+    while (!decisionHeap.empty() && decisionHeap.top().dueMs <= nowMs)
+    {
+        ScheduledDecision decision = decisionHeap.top();
+        decisionHeap.pop();
+
+        auto itr = scheduledBots.find(decision.botGuid);
+        if (itr == scheduledBots.end() || itr->second != decision.generation)
+            continue;
+
+        scheduledBots.erase(itr);
+        botGuid = ObjectGuid(decision.botGuid);
+        return true;
+    }
+
+    // Only stale entries left, do not let them pile up
+    if (scheduledBots.empty())
+        decisionHeap = {};
+    return false;
+}
+
+uint32 GetBotDecisionInterval(Player* bot)
+{
+    if (bot->IsInCombat())
+        return g_OllamaBotControlCombatDecisionInterval;
+    if (bot->isMoving())
+        return g_OllamaBotControlTravelDecisionInterval;
+    return g_OllamaBotControlIdleDecisionInterval;
+}
+
+bool IsBotMovingToPoint(Player* bot)
+{
+    return bot->GetMotionMaster()->GetCurrentMovementGeneratorType() == POINT_MOTION_TYPE && bot->isMoving();
+}
+
+size_t GetScheduledBotCount()
+{
+    return scheduledBots.size();
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include "ObjectGuid.h"
+
+class Player;
+
+// Min-heap of the time each controlled bot is due for its next decision.
+// A bot is in the heap only while it is waiting, never while its request is
+// in flight, and the world update only dispatches from the heap front.
+// Rescheduling leaves the old heap entry behind, it is skipped when popped.
+// World thread only.
+void ScheduleBotDecision(ObjectGuid botGuid, uint64 dueMs);
+void UnscheduleBotDecision(ObjectGuid botGuid);
+
+// Makes a waiting bot due right away, e.g. when it gets attacked. Safe from
+// any thread, the wake-up is applied by the next PopDueBotDecision. Bots that
+// are not waiting, because they are not controlled or their request is in
+// flight, are left alone.
+void WakeBotDecision(ObjectGuid botGuid);
+
+// Pops the next bot whose decision is due at nowMs, if any
+bool PopDueBotDecision(uint64 nowMs, ObjectGuid& botGuid);
+
+// Delay until the next decision, depending on what the bot is doing
+uint32 GetBotDecisionInterval(Player* bot);
+
+// True while the bot is still walking to the point of a move command
+bool IsBotMovingToPoint(Player* bot);
+
+size_t GetScheduledBotCount();
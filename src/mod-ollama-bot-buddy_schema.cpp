@@ -0,0 +1,204 @@
+#include "mod-ollama-bot-buddy_schema.h"
+#include "mod-ollama-bot-buddy_config.h"
+#include <nlohmann/json.hpp>
+#include <cmath>
+#include <limits>
+#include <sstream>
+#include <unordered_map>
+#include <utility>
+
+namespace
+{
+    template<typename Command>
+    constexpr BotCommandParamSpec ToParamSpec(BotCommandParam<Command> const& param)
+    {
+        return { param.name, param.type, param.optional, param.note };
+    }
+
+    template<typename Command, size_t... I>
+    constexpr std::array<BotCommandParamSpec, sizeof...(I)> MakeParamSpecs(std::index_sequence<I...>)
+    {
+        return { { ToParamSpec(BotCommandTraits<Command>::Params[I])... } };
+    }
+
+    template<typename Command>
+    constexpr auto BotCommandParamSpecs = MakeParamSpecs<Command>(std::make_index_sequence<BotCommandTraits<Command>::Params.size()>());
+
+    bool Fail(char const** error, char const* message)
+    {
+        if (error)
+            *error = message;
+        return false;
+    }
+
+    template<typename Command>
+    bool BuildBotCommand(BotCommandArg const* args, size_t count, BotControlCommand& out, char const** error)
+    {
+        Command command;
+        for (BotCommandParam<Command> const& param : BotCommandTraits<Command>::Params)
+        {
+            BotCommandArg const* found = nullptr;
+            for (size_t i = 0; i < count && !found; ++i)
+                if (args[i].name == param.name)
+                    found = &args[i];
+
+            if (!found)
+            {
+                if (param.optional)
+                    continue;
+                return Fail(error, "command is missing a parameter");
+            }
+
+            if (param.type == BotCommandParamType::Number)
+            {
+                // Beyond float range it would turn into inf
+                float value = float(found->value);
+                if (!std::isfinite(value))
+                    return Fail(error, "parameter out of range");
+                command.*param.number = value;
+            }
+            else
+            {
+                if (found->value < 0.0 || found->value > double(std::numeric_limits<uint32>::max()))
+                    return Fail(error, "parameter out of range");
+                command.*param.integer = uint32(found->value);
+            }
+        }
+
+        out = std::move(command);
+        return true;
+    }
+
+    template<typename Command>
+    constexpr BotCommandSpec MakeBotCommandSpec()
+    {
+        return { BotCommandTraits<Command>::Name, BotCommandParamSpecs<Command>.data(), BotCommandParamSpecs<Command>.size(), &BuildBotCommand<Command> };
+    }
+
+    template<size_t... I>
+    constexpr BotCommandSpecTable MakeBotCommandSpecTable(std::index_sequence<I...>)
+    {
+        return { { MakeBotCommandSpec<std::tuple_element_t<I, BotLlmCommands>>()... } };
+    }
+
+    constexpr BotCommandSpecTable botCommandSpecs = MakeBotCommandSpecTable(std::make_index_sequence<std::tuple_size_v<BotLlmCommands>>());
+
+    nlohmann::ordered_json BuildCommandSchema()
+    {
+        nlohmann::ordered_json variants = nlohmann::ordered_json::array();
+        for (BotCommandSpec const& spec : GetBotCommandSpecs())
+        {
+            nlohmann::ordered_json properties = nlohmann::ordered_json::object();
+            nlohmann::ordered_json required = nlohmann::ordered_json::array();
+            for (size_t i = 0; i < spec.paramCount; ++i)
+            {
+                BotCommandParamSpec const& param = spec.params[i];
+                properties[param.name] = { { "type", param.type == BotCommandParamType::Number ? "number" : "integer" } };
+                if (!param.optional)
+                    required.push_back(param.name);
+            }
+
+            nlohmann::ordered_json params = {
+                { "type", "object" },
+                { "properties", std::move(properties) },
+                { "required", std::move(required) }
+            };
+
+            variants.push_back({
+                { "type", "object" },
+                { "properties", {
+                    { "type", { { "enum", nlohmann::ordered_json::array({ spec.name }) } } },
+                    { "params", std::move(params) }
+                } },
+                { "required", nlohmann::ordered_json::array({ "type", "params" }) }
+            });
+        }
+
+        return { { "anyOf", std::move(variants) } };
+    }
+
+    nlohmann::ordered_json BuildDecisionSchema(bool batched)
+    {
+        nlohmann::ordered_json properties = nlohmann::ordered_json::object();
+        nlohmann::ordered_json required = nlohmann::ordered_json::array();
+
+        // Batched replies name the bot each decision is for
+        if (batched)
+        {
+            properties["bot"] = { { "type", "string" } };
+            required.push_back("bot");
+        }
+
+        properties["command"] = BuildCommandSchema();
+        properties["reasoning"] = { { "type", "string" } };
+        properties["say"] = { { "type", "string" } };
+        for (char const* name : { "command", "reasoning", "say" })
+            required.push_back(name);
+
+        return {
+            { "type", "object" },
+            { "properties", std::move(properties) },
+            { "required", std::move(required) }
+        };
+    }
+}
+
+BotCommandSpecTable const& GetBotCommandSpecs()
+{
+    return botCommandSpecs;
+}
+
+std::string BuildBotCommandListPrompt()
+{
+    std::ostringstream oss;
+    for (BotCommandSpec const& spec : GetBotCommandSpecs())
+    {
+        oss << "    - \"" << spec.name << "\": params = { ";
+        for (size_t i = 0; i < spec.paramCount; ++i)
+        {
+            BotCommandParamSpec const& param = spec.params[i];
+            if (i)
+                oss << ", ";
+            oss << "\"" << param.name << "\": " << (param.type == BotCommandParamType::Number ? "float" : "int");
+            if (param.note)
+                oss << " (" << param.note << ")";
+        }
+        oss << (spec.paramCount ? " }" : "}") << "\n";
+    }
+    return oss.str();
+}
+
+OllamaOutputFormat GetBotDecisionFormat()
+{
+    static nlohmann::ordered_json const schema = BuildDecisionSchema(false);
+
+    OllamaOutputFormat format;
+    format.schema = g_OllamaBotControlStructuredOutput ? &schema : nullptr;
+    format.maxTokens = g_OllamaBotControlNumPredict;
+    return format;
+}
+
+OllamaOutputFormat GetBotBatchFormat(size_t batchSize)
+{
+    // One schema per batch size, the array length is part of it
+    static std::unordered_map<size_t, nlohmann::ordered_json> schemas;
+
+    OllamaOutputFormat format;
+    format.maxTokens = g_OllamaBotControlNumPredict * uint32(batchSize);
+    if (!g_OllamaBotControlStructuredOutput)
+        return format;
+
+    auto itr = schemas.find(batchSize);
+    if (itr == schemas.end())
+    {
+        nlohmann::ordered_json schema = {
+            { "type", "array" },
+            { "items", BuildDecisionSchema(true) },
+            { "minItems", batchSize },
+            { "maxItems", batchSize }
+        };
+        itr = schemas.emplace(batchSize, std::move(schema)).first;
+    }
+    format.schema = &itr->second;
+    return format;
+}
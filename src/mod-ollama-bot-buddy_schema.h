@@ -0,0 +1,53 @@
+#pragma once
+#include "mod-ollama-bot-buddy_api.h"
+#include "mod-ollama-bot-buddy_http.h"
+#include <array>
+#include <string>
+#include <string_view>
+#include <tuple>
+
+// The commands an LLM reply may contain, in the order the rules prompt lists them
+using BotLlmCommands = std::tuple<MoveToCommand, AttackCommand, InteractCommand, CastSpellCommand, LootCommand,
+    AcceptQuestCommand, TurnInQuestCommand, FollowCommand, StopCommand>;
+
+// A numeric param value as read from a reply, before it is known which command it belongs to
+struct BotCommandArg
+{
+    std::string_view name;
+    double value;
+};
+
+struct BotCommandParamSpec
+{
+    char const* name;
+    BotCommandParamType type;
+    bool optional;
+    char const* note;  // appended in the rules prompt, may be null
+};
+
+// One entry per command of BotLlmCommands, generated at compile time from
+// their BotCommandTraits. The command list of the rules prompt, the JSON
+// schema sent in Ollama's format field and the reply decoder all use it, so
+// what the model is told, what it may produce and what is understood cannot
+// drift apart.
+struct BotCommandSpec
+{
+    char const* name;
+    BotCommandParamSpec const* params;
+    size_t paramCount;
+    // Builds the typed command from the args decoded for this type, in any order
+    bool (*build)(BotCommandArg const* args, size_t count, BotControlCommand& command, char const** error);
+};
+
+using BotCommandSpecTable = std::array<BotCommandSpec, std::tuple_size_v<BotLlmCommands>>;
+
+BotCommandSpecTable const& GetBotCommandSpecs();
+
+// One "- "type": params = { ... }" line per command, for the rules prompt
+std::string BuildBotCommandListPrompt();
+
+// Output constraints of a single decision and of a batched reply with batchSize
+// decisions. Without OllamaBotControl.StructuredOutput only the token cap is set.
+// World thread only.
+OllamaOutputFormat GetBotDecisionFormat();
+OllamaOutputFormat GetBotBatchFormat(size_t batchSize);
@@ -0,0 +1,69 @@
+#include "mod-ollama-bot-buddy_session.h"
+#include "mod-ollama-bot-buddy_config.h"
+#include "mod-ollama-bot-buddy_http.h"
+#include "mod-ollama-bot-buddy_prompt.h"
+#include "mod-ollama-bot-buddy_schema.h"
+#include "Log.h"
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+    struct BotSession
+    {
+        std::vector<OllamaChatTurn> turns;
+        size_t chars = 0;
+    };
+
+    std::unordered_map<uint64, BotSession> botSessions;
+    std::mutex botSessionsMutex;
+
+    std::atomic<uint64> botSessionResets { 0 };
+}
+
+std::string BuildBotSessionRequest(ObjectGuid botGuid, const std::string& system, const std::string& statePrompt, bool* reset)
+{
+    std::vector<OllamaChatTurn> history;
+    {
+        std::lock_guard<std::mutex> lock(botSessionsMutex);
+        BotSession& session = botSessions[botGuid.GetRawValue()];
+
+        size_t total = system.size() + session.chars + statePrompt.size();
+        if (!session.turns.empty() && EstimatePromptTokens(total) > g_OllamaBotControlSessionMaxTokens)
+        {
+            if (g_EnableOllamaBotBuddyDebug)
+                LOG_INFO("server.loading", "[OllamaBotBuddy] Session for {} reached ~{} tokens, starting a new conversation",
+                    botGuid.ToString(), EstimatePromptTokens(total));
+            session.turns.clear();
+            session.chars = 0;
+            ++botSessionResets;
+            if (reset)
+                *reset = true;
+        }
+
+        history = session.turns;
+    }
+
+    return BuildOllamaChatBody(system, history, statePrompt, GetBotDecisionFormat());
+}
+
+void RecordBotSessionTurn(ObjectGuid botGuid, const std::string& statePrompt, const std::string& reply)
+{
+    std::lock_guard<std::mutex> lock(botSessionsMutex);
+    BotSession& session = botSessions[botGuid.GetRawValue()];
+    session.turns.push_back({ statePrompt, reply });
+    session.chars += statePrompt.size() + reply.size();
+}
+
+void ResetBotSession(ObjectGuid botGuid)
+{
+    std::lock_guard<std::mutex> lock(botSessionsMutex);
+    botSessions.erase(botGuid.GetRawValue());
+}
+
+uint64 GetBotSessionResets()
+{
+    return botSessionResets.load();
+}
@@ -0,0 +1,20 @@
+#pragma once
+#include "ObjectGuid.h"
+#include <string>
+
+// Session mode keeps one /api/chat conversation per bot. The static rules go
+// first as the system prompt and every decision only appends the current
+// world state, so the server can reuse the evaluated prefix instead of
+// re-reading the whole rules text each time.
+
+// Builds the /api/chat request for the bot's next decision. Resets the
+// conversation first if it would no longer fit the configured token budget,
+// in which case reset is set.
+std::string BuildBotSessionRequest(ObjectGuid botGuid, const std::string& system, const std::string& statePrompt, bool* reset = nullptr);
+
+// Appends a finished turn to the bot's conversation. Safe to call from any thread.
+void RecordBotSessionTurn(ObjectGuid botGuid, const std::string& statePrompt, const std::string& reply);
+
+void ResetBotSession(ObjectGuid botGuid);
+
+uint64 GetBotSessionResets();
@@ -0,0 +1,160 @@
+#include "mod-ollama-bot-buddy_spells.h"
+#include "mod-ollama-bot-buddy_registry.h"
+#include "Log.h"
+#include "MPSCQueue.h"
+#include "Player.h"
+#include "SharedDefines.h"
+#include "SpellInfo.h"
+#include "SpellMgr.h"
+#include "StringFormat.h"
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+    // spellId => "**Name** (ID: x) - Effect, Costs y.\n"
+    std::unordered_map<uint32, std::string> spellDescriptors;
+
+    // What the cached list was built from. Unlearned spells stay in the spell
+    // map as removed, so its size alone misses an unlearn followed by a learn;
+    // the learn and forget hooks drop the entry for that.
+    struct BotSpellSummary
+    {
+        bool built = false;
+        size_t spellMapSize = 0;
+        uint8 activeSpec = 0;
+        std::vector<std::pair<uint32, std::string const*>> spells;
+    };
+
+    std::unordered_map<uint64, BotSpellSummary> botSpellSummaries;
+    // Bots that learned or forgot a spell, filled from map threads
+    MPSCQueue<ObjectGuid> changedSpellBots;
+
+    std::string RenderSpellDescriptor(SpellInfo const* spellInfo)
+    {
+        if (spellInfo->Attributes & SPELL_ATTR0_PASSIVE)
+            return "";
+
+        if (spellInfo->SpellFamilyName == SPELLFAMILY_GENERIC)
+            return "";
+
+        std::string effectText;
+        for (int i = 0; i < MAX_SPELL_EFFECTS; ++i)
+        {
+            if (!spellInfo->Effects[i].IsEffect())
+                continue;
+
+            switch (spellInfo->Effects[i].Effect)
+            {
+                case SPELL_EFFECT_SCHOOL_DAMAGE: effectText = "Deals damage"; break;
+                case SPELL_EFFECT_HEAL: effectText = "Heals the target"; break;
+                case SPELL_EFFECT_APPLY_AURA: effectText = "Applies an aura"; break;
+                case SPELL_EFFECT_DISPEL: effectText = "Dispels magic"; break;
+                case SPELL_EFFECT_THREAT: effectText = "Generates threat"; break;
+                default: continue;
+            }
+            break;
+        }
+
+        if (effectText.empty())
+            return "";
+
+        const char* name = spellInfo->SpellName[0];
+        if (!name || !*name)
+            return "";
+
+        std::string costText;
+        if (spellInfo->ManaCost || spellInfo->ManaCostPercentage)
+        {
+            switch (spellInfo->PowerType)
+            {
+                case POWER_MANA: costText = std::to_string(spellInfo->ManaCost) + " mana"; break;
+                case POWER_RAGE: costText = std::to_string(spellInfo->ManaCost) + " rage"; break;
+                case POWER_FOCUS: costText = std::to_string(spellInfo->ManaCost) + " focus"; break;
+                case POWER_ENERGY: costText = std::to_string(spellInfo->ManaCost) + " energy"; break;
+                case POWER_RUNIC_POWER: costText = std::to_string(spellInfo->ManaCost) + " runic power"; break;
+                default: costText = std::to_string(spellInfo->ManaCost) + " unknown resource"; break;
+            }
+        }
+        else
+        {
+            costText = "no cost";
+        }
+
+        return fmt::format("**{}** (ID: {}) - {}, Costs {}.\n", name, spellInfo->Id, effectText, costText);
+    }
+}
+
+void BuildSpellDescriptorTable()
+{
+    spellDescriptors.clear();
+    botSpellSummaries.clear();
+
+    for (uint32 spellId = 0; spellId < sSpellMgr->GetSpellInfoStoreSize(); ++spellId)
+    {
+        SpellInfo const* spellInfo = sSpellMgr->GetSpellInfo(spellId);
+        if (!spellInfo)
+            continue;
+
+        std::string descriptor = RenderSpellDescriptor(spellInfo);
+        if (!descriptor.empty())
+            spellDescriptors.emplace(spellId, std::move(descriptor));
+    }
+
+    LOG_INFO("server.loading", "[OllamaBotBuddy] Prepared {} spell descriptors.", spellDescriptors.size());
+}
+
+std::string GetBotSpellInfo(Player* bot)
+{
+    if (spellDescriptors.empty())
+        BuildSpellDescriptorTable();
+
+    PlayerSpellMap const& spellMap = bot->GetSpellMap();
+    BotSpellSummary& summary = botSpellSummaries[bot->GetGUID().GetRawValue()];
+
+    if (!summary.built || summary.spellMapSize != spellMap.size() || summary.activeSpec != bot->GetActiveSpec())
+    {
+        summary.built = true;
+        summary.spellMapSize = spellMap.size();
+        summary.activeSpec = bot->GetActiveSpec();
+        summary.spells.clear();
+        for (const auto& spellPair : spellMap)
+        {
+            auto itr = spellDescriptors.find(spellPair.first);
+            if (itr != spellDescriptors.end())
+                summary.spells.emplace_back(spellPair.first, &itr->second);
+        }
+    }
+
+    std::string spellSummary;
+    for (auto const& [spellId, descriptor] : summary.spells)
+    {
+        if (bot->HasSpellCooldown(spellId))
+            continue;
+        spellSummary += *descriptor;
+    }
+
+    return spellSummary;
+}
+
+void RemoveBotSpellSummary(ObjectGuid botGuid)
+{
+    botSpellSummaries.erase(botGuid.GetRawValue());
+}
+
+void InvalidateBotSpellSummary(ObjectGuid botGuid)
+{
+    changedSpellBots.Enqueue(new ObjectGuid(botGuid));
+}
+
+void ProcessBotSpellChanges()
+{
+    ObjectGuid* changed = nullptr;
+    while (changedSpellBots.Dequeue(changed))
+    {
+        std::unique_ptr<ObjectGuid> owned(changed);
+        if (IsControlledBot(*owned))
+            botSpellSummaries.erase(owned->GetRawValue());
+    }
+}
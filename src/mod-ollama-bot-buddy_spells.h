@@ -0,0 +1,19 @@
+#pragma once
+#include "ObjectGuid.h"
+#include <string>
+
+class Player;
+
+// Prompt lines for every spell worth listing, rendered once for all bots.
+void BuildSpellDescriptorTable();
+
+// Summary of the bot's usable spells. The list of known spells is cached per
+// bot and only rebuilt when a spell is learned or forgotten, the spell map
+// changes size or the bot switches spec; cooldowns are applied per call.
+std::string GetBotSpellInfo(Player* bot);
+void RemoveBotSpellSummary(ObjectGuid botGuid);
+
+// Marks the bot's cached spell list as stale. Lock-free, safe from map threads.
+void InvalidateBotSpellSummary(ObjectGuid botGuid);
+// Drops the lists marked stale since the last call, world thread only
+void ProcessBotSpellChanges();
@@ -0,0 +1,138 @@
+#include "mod-ollama-bot-buddy_stats.h"
+#include "StringFormat.h"
+#include <algorithm>
+#include <iterator>
+
+namespace
+{
+    std::array<BotStatHistogram, size_t(BotLatencyStage::Max)> latencies;
+    std::array<BotStatHistogram, size_t(BotSizeStat::Max)> sizes;
+    std::array<std::atomic<uint64>, size_t(BotCounter::Max)> counters {};
+
+    char const* const latencyNames[] = { "Prompt", "Queue", "First token", "Generation", "Parse", "Execute" };
+    char const* const sizeNames[] = { "Prompt bytes", "Response bytes", "Prompt tokens", "Response tokens" };
+    static_assert(std::size(latencyNames) == size_t(BotLatencyStage::Max));
+    static_assert(std::size(sizeNames) == size_t(BotSizeStat::Max));
+
+    uint32 GetHighestBit(uint64 value)
+    {
+        uint32 bit = 0;
+        for (uint32 step = 32; step; step >>= 1)
+        {
+            if (value >> step)
+            {
+                value >>= step;
+                bit += step;
+            }
+        }
+        return bit;
+    }
+
+    std::string FormatMs(uint64 us)
+    {
+        return Acore::StringFormat("{:.1f} ms", double(us) / 1000.0);
+    }
+}
+
+uint32 BotStatHistogram::GetBucket(uint64 value)
+{
+    // Values below SUB_BUCKETS get a bucket each, every power of two above is split in SUB_BUCKETS
+    if (value < SUB_BUCKETS)
+        return uint32(value);
+
+    uint32 bit = GetHighestBit(value);
+    uint32 shift = bit - SUB_BUCKET_BITS;
+    return (bit - SUB_BUCKET_BITS + 1) * SUB_BUCKETS + uint32((value >> shift) & (SUB_BUCKETS - 1));
+}
+
+uint64 BotStatHistogram::GetBucketUpperBound(uint32 bucket)
+{
+    if (bucket < SUB_BUCKETS)
+        return bucket;
+
+    uint32 shift = bucket / SUB_BUCKETS - 1;
+    uint64 lower = uint64(SUB_BUCKETS + bucket % SUB_BUCKETS) << shift;
+    return lower + ((uint64(1) << shift) - 1);
+}
+
+void BotStatHistogram::Record(uint64 value)
+{
+    _buckets[GetBucket(value)].fetch_add(1, std::memory_order_relaxed);
+    _count.fetch_add(1, std::memory_order_relaxed);
+    _sum.fetch_add(value, std::memory_order_relaxed);
+
+    uint64 max = _max.load(std::memory_order_relaxed);
+    while (value > max && !_max.compare_exchange_weak(max, value, std::memory_order_relaxed))
+        ;
+}
+
+uint64 BotStatHistogram::GetMean() const
+{
+    uint64 count = GetCount();
+    return count ? _sum.load(std::memory_order_relaxed) / count : 0;
+}
+
+uint64 BotStatHistogram::GetPercentile(double fraction) const
+{
+    // Buckets are read one by one while others record, the total is taken from them so the rank stays inside
+    uint64 total = 0;
+    for (auto const& bucket : _buckets)
+        total += bucket.load(std::memory_order_relaxed);
+    if (!total)
+        return 0;
+
+    uint64 rank = std::max<uint64>(1, uint64(fraction * double(total) + 0.5));
+    uint64 seen = 0;
+    for (uint32 i = 0; i < BUCKETS; ++i)
+    {
+        seen += _buckets[i].load(std::memory_order_relaxed);
+        if (seen >= rank)
+            return std::min(GetBucketUpperBound(i), GetMax());
+    }
+    return GetMax();
+}
+
+void RecordBotLatency(BotLatencyStage stage, std::chrono::steady_clock::duration elapsed)
+{
+    latencies[size_t(stage)].Record(uint64(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count()));
+}
+
+void RecordBotSize(BotSizeStat stat, uint64 value)
+{
+    sizes[size_t(stat)].Record(value);
+}
+
+void CountBotEvent(BotCounter counter)
+{
+    counters[size_t(counter)].fetch_add(1, std::memory_order_relaxed);
+}
+
+std::vector<std::string> FormatBotStats()
+{
+    std::vector<std::string> lines;
+    lines.push_back(Acore::StringFormat("Requests: {}, failures: {}, timeouts: {}, parse errors: {}",
+        counters[size_t(BotCounter::Requests)].load(), counters[size_t(BotCounter::Failures)].load(),
+        counters[size_t(BotCounter::Timeouts)].load(), counters[size_t(BotCounter::ParseErrors)].load()));
+
+    for (size_t i = 0; i < latencies.size(); ++i)
+    {
+        BotStatHistogram const& histogram = latencies[i];
+        if (!histogram.GetCount())
+            continue;
+        lines.push_back(Acore::StringFormat("{}: {} samples, p50 {}, p95 {}, p99 {}, max {}", latencyNames[i], histogram.GetCount(),
+            FormatMs(histogram.GetPercentile(0.50)), FormatMs(histogram.GetPercentile(0.95)),
+            FormatMs(histogram.GetPercentile(0.99)), FormatMs(histogram.GetMax())));
+    }
+
+    for (size_t i = 0; i < sizes.size(); ++i)
+    {
+        BotStatHistogram const& histogram = sizes[i];
+        if (!histogram.GetCount())
+            continue;
+        lines.push_back(Acore::StringFormat("{}: {} samples, mean {}, p50 {}, p95 {}, p99 {}, max {}", sizeNames[i], histogram.GetCount(),
+            histogram.GetMean(), histogram.GetPercentile(0.50), histogram.GetPercentile(0.95),
+            histogram.GetPercentile(0.99), histogram.GetMax()));
+    }
+
+    return lines;
+}
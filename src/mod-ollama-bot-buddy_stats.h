@@ -0,0 +1,87 @@
+#pragma once
+#include "Define.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+
+// Where the time of one decision goes, in the order a decision goes through them
+enum class BotLatencyStage : uint8
+{
+    Prompt,      // snapshot, rendering and events, world thread
+    Queue,       // submitted until the I/O thread starts the transfer
+    FirstToken,  // transfer started until the first streamed byte: connection and prompt evaluation
+    Generation,  // first byte until the transfer finished
+    Parse,       // JSON extraction and decoding, worker
+    Execute,     // HandleBotControlCommand, world thread
+    Max
+};
+
+enum class BotSizeStat : uint8
+{
+    PromptBytes,     // request body
+    ResponseBytes,   // generated text
+    PromptTokens,    // as reported by Ollama, missing when the stream was cut early
+    ResponseTokens,
+    Max
+};
+
+enum class BotCounter : uint8
+{
+    Requests,
+    Failures,
+    Timeouts,
+    ParseErrors,
+    Max
+};
+
+// Fixed log-linear buckets, 8 per power of two, so percentiles are within
+// 12.5% of the recorded values. Recording is a couple of relaxed atomic
+// increments, safe from any thread without a lock.
+class BotStatHistogram
+{
+public:
+    void Record(uint64 value);
+
+    uint64 GetCount() const { return _count.load(std::memory_order_relaxed); }
+    uint64 GetMax() const { return _max.load(std::memory_order_relaxed); }
+    uint64 GetMean() const;
+    // Upper bound of the bucket holding the given fraction (0.5 for p50) of the samples
+    uint64 GetPercentile(double fraction) const;
+
+private:
+    static constexpr uint32 SUB_BUCKET_BITS = 3;
+    static constexpr uint32 SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+    static constexpr uint32 BUCKETS = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+    static uint32 GetBucket(uint64 value);
+    static uint64 GetBucketUpperBound(uint32 bucket);
+
+    std::array<std::atomic<uint64>, BUCKETS> _buckets {};
+    std::atomic<uint64> _count { 0 };
+    std::atomic<uint64> _sum { 0 };
+    std::atomic<uint64> _max { 0 };
+};
+
+void RecordBotLatency(BotLatencyStage stage, std::chrono::steady_clock::duration elapsed);
+void RecordBotSize(BotSizeStat stat, uint64 value);
+void CountBotEvent(BotCounter counter);
+
+// Records the time between its construction and its destruction
+class BotStageTimer
+{
+public:
+    explicit BotStageTimer(BotLatencyStage stage) : _stage(stage), _start(std::chrono::steady_clock::now()) {}
+    ~BotStageTimer() { RecordBotLatency(_stage, std::chrono::steady_clock::now() - _start); }
+
+    BotStageTimer(BotStageTimer const&) = delete;
+    BotStageTimer& operator=(BotStageTimer const&) = delete;
+
+private:
+    BotLatencyStage _stage;
+    std::chrono::steady_clock::time_point _start;
+};
+
+// One line per counter group, stage and size, for .buddy stats and the status log
+std::vector<std::string> FormatBotStats();
@@ -0,0 +1,93 @@
+#include "mod-ollama-bot-buddy_targets.h"
+#include "Creature.h"
+#include "GameObject.h"
+#include "ObjectAccessor.h"
+#include "Player.h"
+#include <unordered_map>
+
+namespace
+{
+    struct BotTargetIndex
+    {
+        std::unordered_map<uint32, ObjectGuid> creatures;
+        std::unordered_map<uint32, ObjectGuid> gameObjects;
+    };
+
+    std::unordered_map<uint64, BotTargetIndex> botTargetIndexes;
+
+    BotTargetIndex const* FindIndex(Player* bot)
+    {
+        if (!bot)
+            return nullptr;
+        auto itr = botTargetIndexes.find(bot->GetGUID().GetRawValue());
+        return itr != botTargetIndexes.end() ? &itr->second : nullptr;
+    }
+}
+
+void ResetBotTargetIndex(Player* bot)
+{
+    if (!bot)
+        return;
+    BotTargetIndex& index = botTargetIndexes[bot->GetGUID().GetRawValue()];
+    index.creatures.clear();
+    index.gameObjects.clear();
+}
+
+void IndexBotTarget(Player* bot, WorldObject const* target)
+{
+    if (!bot || !target)
+        return;
+
+    // Players are found by counter alone, only creatures and gameobjects need the full GUID
+    ObjectGuid guid = target->GetGUID();
+    if (guid.IsCreatureOrVehicle())
+        botTargetIndexes[bot->GetGUID().GetRawValue()].creatures[guid.GetCounter()] = guid;
+    else if (guid.IsGameObject())
+        botTargetIndexes[bot->GetGUID().GetRawValue()].gameObjects[guid.GetCounter()] = guid;
+}
+
+void RemoveBotTargetIndex(ObjectGuid botGuid)
+{
+    botTargetIndexes.erase(botGuid.GetRawValue());
+}
+
+Creature* ResolveBotCreature(Player* bot, uint32 lowGuid)
+{
+    BotTargetIndex const* index = FindIndex(bot);
+    if (!index)
+        return nullptr;
+    auto itr = index->creatures.find(lowGuid);
+    return itr != index->creatures.end() ? ObjectAccessor::GetCreature(*bot, itr->second) : nullptr;
+}
+
+GameObject* ResolveBotGameObject(Player* bot, uint32 lowGuid)
+{
+    BotTargetIndex const* index = FindIndex(bot);
+    if (!index)
+        return nullptr;
+    auto itr = index->gameObjects.find(lowGuid);
+    return itr != index->gameObjects.end() ? ObjectAccessor::GetGameObject(*bot, itr->second) : nullptr;
+}
+
+Unit* ResolveBotUnit(Player* bot, uint32 lowGuid)
+{
+    if (Creature* creature = ResolveBotCreature(bot, lowGuid))
+        return creature;
+    return ObjectAccessor::FindConnectedPlayer(ObjectGuid::Create<HighGuid::Player>(lowGuid));
+}
+
+std::vector<Creature*> GetIndexedBotCreatures(Player* bot)
+{
+    std::vector<Creature*> creatures;
+    BotTargetIndex const* index = FindIndex(bot);
+    if (!index)
+        return creatures;
+
+    creatures.reserve(index->creatures.size());
+    for (auto const& [lowGuid, guid] : index->creatures)
+    {
+        if (Creature* creature = ObjectAccessor::GetCreature(*bot, guid))
+            creatures.push_back(creature);
+    }
+    return creatures;
+}
@@ -0,0 +1,25 @@
+#pragma once
+#include "ObjectGuid.h"
+#include <vector>
+
+class Creature;
+class GameObject;
+class Player;
+class Unit;
+class WorldObject;
+
+// Resolves the low GUID counters shown to the LLM back to game objects in
+// constant time. Every entity written into a bot's prompt is recorded here,
+// so the index always matches the snapshot the bot's next command refers to.
+// World thread only.
+void ResetBotTargetIndex(Player* bot);
+void IndexBotTarget(Player* bot, WorldObject const* target);
+void RemoveBotTargetIndex(ObjectGuid botGuid);
+
+Creature* ResolveBotCreature(Player* bot, uint32 lowGuid);
+GameObject* ResolveBotGameObject(Player* bot, uint32 lowGuid);
+// Creature from the snapshot first, then any connected player with that counter
+Unit* ResolveBotUnit(Player* bot, uint32 lowGuid);
+
+// Creatures from the bot's last snapshot that are still on its map
+std::vector<Creature*> GetIndexedBotCreatures(Player* bot);
@@ -0,0 +1,104 @@
+#include "mod-ollama-bot-buddy_waypoints.h"
+#include "Log.h"
+#include "TravelMgr.h"
+#include "TravelNode.h"
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+
+namespace
+{
+    // Matches the default waypoint radius, so a query touches at most 3x3 cells
+    constexpr float TRAVEL_NODE_CELL_SIZE = 200.0f;
+
+    struct TravelNodeEntry
+    {
+        TravelNode* node;
+        float x, y, z;
+    };
+
+    using TravelNodeGrid = std::unordered_map<uint64, std::vector<TravelNodeEntry>>;
+
+    std::unordered_map<uint32, TravelNodeGrid> travelNodeGrids;
+    size_t indexedNodeCount = 0;
+    size_t sourceNodeCount = 0;
+    bool travelNodeIndexBuilt = false;
+
+    int32 CellCoord(float value)
+    {
+        return int32(std::floor(value / TRAVEL_NODE_CELL_SIZE));
+    }
+
+    uint64 CellKey(int32 cellX, int32 cellY)
+    {
+        return (uint64(uint32(cellX)) << 32) | uint32(cellY);
+    }
+}
+
+void RebuildTravelNodeIndex()
+{
+    travelNodeGrids.clear();
+    indexedNodeCount = 0;
+
+    std::vector<TravelNode*> nodes = sTravelNodeMap->getNodes();
+    sourceNodeCount = nodes.size();
+    for (TravelNode* node : nodes)
+    {
+        if (!node) continue;
+        WorldPosition* pos = node->getPosition();
+        if (!pos) continue;
+
+        TravelNodeEntry entry { node, pos->getX(), pos->getY(), pos->getZ() };
+        travelNodeGrids[pos->getMapId()][CellKey(CellCoord(entry.x), CellCoord(entry.y))].push_back(entry);
+        ++indexedNodeCount;
+    }
+
+    travelNodeIndexBuilt = true;
+    LOG_INFO("server.loading", "[OllamaBotBuddy] Indexed {} travel nodes on {} maps.", indexedNodeCount, travelNodeGrids.size());
+}
+
+void CheckTravelNodeIndex()
+{
+    if (!travelNodeIndexBuilt || sTravelNodeMap->getNodes().size() != sourceNodeCount)
+        RebuildTravelNodeIndex();
+}
+
+void QueryNearbyTravelNodes(uint32 mapId, float x, float y, float z, float radius, std::vector<NearbyTravelNode>& out)
+{
+    // Playerbots may still be generating nodes when the first bot asks
+    if (!travelNodeIndexBuilt)
+        RebuildTravelNodeIndex();
+
+    auto gridItr = travelNodeGrids.find(mapId);
+    if (gridItr == travelNodeGrids.end())
+        return;
+    TravelNodeGrid const& grid = gridItr->second;
+
+    float radiusSq = radius * radius;
+    for (int32 cellX = CellCoord(x - radius); cellX <= CellCoord(x + radius); ++cellX)
+    {
+        for (int32 cellY = CellCoord(y - radius); cellY <= CellCoord(y + radius); ++cellY)
+        {
+            auto cellItr = grid.find(CellKey(cellX, cellY));
+            if (cellItr == grid.end())
+                continue;
+
+            for (TravelNodeEntry const& entry : cellItr->second)
+            {
+                float dx = entry.x - x;
+                float dy = entry.y - y;
+                float dz = entry.z - z;
+                float distSq = dx * dx + dy * dy + dz * dz;
+                if (distSq <= radiusSq)
+                    out.push_back({ entry.node, entry.x, entry.y, entry.z, distSq });
+            }
+        }
+    }
+
+    std::sort(out.begin(), out.end(), [](NearbyTravelNode const& a, NearbyTravelNode const& b) { return a.distSq < b.distSq; });
+}
+
+size_t GetTravelNodeIndexSize()
+{
+    return indexedNodeCount;
+}
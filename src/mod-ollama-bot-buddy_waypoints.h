@@ -0,0 +1,25 @@
+#pragma once
+#include "Define.h"
+#include <vector>
+
+class TravelNode;
+
+struct NearbyTravelNode
+{
+    TravelNode* node;
+    float x, y, z;
+    float distSq;
+};
+
+// Uniform grid over the playerbots travel nodes, one per map, so radius
+// queries only look at the cells around the bot instead of every node in
+// the world. World thread only.
+void RebuildTravelNodeIndex();
+
+// Rebuilds the index if playerbots added or removed travel nodes since the last build.
+void CheckTravelNodeIndex();
+
+// Nodes within radius of the position, nearest first
+void QueryNearbyTravelNodes(uint32 mapId, float x, float y, float z, float radius, std::vector<NearbyTravelNode>& out);
+
+size_t GetTravelNodeIndexSize();
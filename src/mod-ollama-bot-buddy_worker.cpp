@@ -0,0 +1,111 @@
+#include "mod-ollama-bot-buddy_worker.h"
+#include "Log.h"
+#include <algorithm>
+#include <chrono>
+
+OllamaWorkerPool* OllamaWorkerPool::instance()
+{
+    static OllamaWorkerPool instance;
+    return &instance;
+}
+
+OllamaWorkerPool::~OllamaWorkerPool()
+{
+    Stop();
+}
+
+void OllamaWorkerPool::Start(uint32 workerCount, uint32 maxQueuedJobs)
+{
+    Stop();
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _maxQueuedJobs = std::max<uint32>(1, maxQueuedJobs);
+    _running = true;
+
+    workerCount = std::max<uint32>(1, workerCount);
+    _workers.reserve(workerCount);
+    for (uint32 i = 0; i < workerCount; ++i)
+        _workers.emplace_back(&OllamaWorkerPool::WorkerMain, this);
+
+    LOG_INFO("server.loading", "[OllamaBotBuddy] Started {} LLM worker threads (queue depth {}).", workerCount, _maxQueuedJobs);
+}
+
+void OllamaWorkerPool::Stop()
+{
+    std::vector<std::thread> workers;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_running && _workers.empty())
+            return;
+        _running = false;
+        _jobs.clear();
+        workers.swap(_workers);
+    }
+    _condition.notify_all();
+
+    for (std::thread& worker : workers)
+    {
+        if (worker.joinable())
+            worker.join();
+    }
+}
+
+bool OllamaWorkerPool::Enqueue(Job job)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_running || _jobs.size() >= _maxQueuedJobs)
+        {
+            ++_rejectedJobs;
+            return false;
+        }
+        _jobs.push_back(std::move(job));
+    }
+    _condition.notify_one();
+    return true;
+}
+
+uint32 OllamaWorkerPool::GetWorkerCount() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return uint32(_workers.size());
+}
+
+uint32 OllamaWorkerPool::GetQueueDepth() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return uint32(_jobs.size());
+}
+
+void OllamaWorkerPool::WorkerMain()
+{
+    while (true)
+    {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _condition.wait(lock, [this] { return !_running || !_jobs.empty(); });
+            if (!_running)
+                return;
+            job = std::move(_jobs.front());
+            _jobs.pop_front();
+        }
+
+        ++_busyWorkers;
+        auto start = std::chrono::steady_clock::now();
+
+        try
+        {
+            job();
+        }
+        catch (const std::exception& e)
+        {
+            LOG_ERROR("server.loading", "[OllamaBotBuddy] Worker job failed: {}", e.what());
+        }
+
+        auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+        _busyTimeUs += uint64(elapsed.count());
+        ++_completedJobs;
+        --_busyWorkers;
+    }
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include "Define.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed-size pool of worker threads fed by a bounded job queue.
+// Used for all off-thread LLM work so the number of threads stays constant
+// no matter how many bots are controlled.
+class OllamaWorkerPool
+{
+public:
+    using Job = std::function<void()>;
+
+    static OllamaWorkerPool* instance();
+
+    void Start(uint32 workerCount, uint32 maxQueuedJobs);
+    void Stop();
+
+    // Returns false (and drops the job) when the pool is stopped or the queue is full.
+    bool Enqueue(Job job);
+
+    uint32 GetWorkerCount() const;
+    uint32 GetQueueDepth() const;
+    uint32 GetMaxQueueDepth() const { return _maxQueuedJobs; }
+    uint32 GetBusyWorkers() const { return _busyWorkers.load(); }
+    uint64 GetBusyTimeUs() const { return _busyTimeUs.load(); }
+    uint64 GetCompletedJobs() const { return _completedJobs.load(); }
+    uint64 GetRejectedJobs() const { return _rejectedJobs.load(); }
+
+private:
+    OllamaWorkerPool() = default;
+    ~OllamaWorkerPool();
+
+    void WorkerMain();
+
+    std::vector<std::thread> _workers;
+    std::deque<Job> _jobs;
+    mutable std::mutex _mutex;
+    std::condition_variable _condition;
+    uint32 _maxQueuedJobs = 0;
+    bool _running = false;
+
+    std::atomic<uint32> _busyWorkers { 0 };
+    std::atomic<uint64> _busyTimeUs { 0 };
+    std::atomic<uint64> _completedJobs { 0 };
+    std::atomic<uint64> _rejectedJobs { 0 };
+};
+
+#define sOllamaWorkerPool OllamaWorkerPool::instance()
@@ -0,0 +1,162 @@
+// Compares the single pass decision decoder with the nlohmann DOM parse it
+// replaced: heap allocations and time per decision for typical LLM replies.
+// Build and run instructions are in README.md next to this file.
+
+#include "mod-ollama-bot-buddy_config.h"
+#include "mod-ollama-bot-buddy_decoder.h"
+#include <nlohmann/json.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+// The command specs of the schema read these, the module defines them in its config
+bool g_OllamaBotControlStructuredOutput = true;
+uint32 g_OllamaBotControlNumPredict = 256;
+
+namespace
+{
+    std::atomic<uint64> allocations { 0 };
+}
+
+void* operator new(std::size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size ? size : 1))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+namespace
+{
+    // The decision as the old code kept it: a type and its params as strings
+    struct LegacyDecision
+    {
+        std::string type;
+        std::vector<std::string> args;
+        std::string commandText;
+        std::string reasoning;
+        std::string say;
+    };
+
+    // The old path: DOM parse, dump of the command for the history, params
+    // converted to strings by ParseBotJson and back to numbers by HandleBotControlCommand
+    bool LegacyDecode(std::string const& json, LegacyDecision& decision, uint64& sink)
+    {
+        try
+        {
+            auto root = nlohmann::json::parse(json);
+            if (!root.contains("command"))
+                return false;
+            auto cmd = root["command"];
+            if (!cmd.contains("type") || !cmd.contains("params"))
+                return false;
+
+            decision.type = cmd["type"].get<std::string>();
+            auto params = cmd["params"];
+            decision.say = root.value("say", "");
+            decision.reasoning = root.value("reasoning", "");
+            decision.commandText = cmd.dump();
+
+            if (decision.type == "move_to")
+            {
+                decision.args = { std::to_string(params["x"].get<float>()), std::to_string(params["y"].get<float>()),
+                    std::to_string(params["z"].get<float>()) };
+                sink += uint64(std::stof(decision.args[0]) + std::stof(decision.args[1]) + std::stof(decision.args[2]));
+            }
+            else if (decision.type == "attack")
+            {
+                decision.args = { std::to_string(params["guid"].get<uint32>()) };
+                sink += std::stoul(decision.args[0]);
+            }
+            else if (decision.type == "spell")
+            {
+                decision.args = { std::to_string(params["spellid"].get<uint32>()) };
+                if (params.contains("guid"))
+                    decision.args.push_back(std::to_string(params["guid"].get<uint32>()));
+                for (std::string const& arg : decision.args)
+                    sink += std::stoul(arg);
+            }
+            return true;
+        }
+        catch (...)
+        {
+            return false;
+        }
+    }
+
+    struct Sample
+    {
+        char const* name;
+        std::string reply;
+    };
+
+    template<typename Decode>
+    void Measure(char const* label, std::string const& reply, uint32 iterations, Decode&& decode)
+    {
+        // The first call counts the allocations of one decision, caches are warm for the loop after it
+        uint64 before = allocations.load(std::memory_order_relaxed);
+        decode(reply);
+        uint64 perDecision = allocations.load(std::memory_order_relaxed) - before;
+
+        auto start = std::chrono::steady_clock::now();
+        for (uint32 i = 0; i < iterations; ++i)
+            decode(reply);
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / iterations;
+
+        std::printf("  %-8s %4llu allocations, %8.0f ns\n", label, static_cast<unsigned long long>(perDecision), ns);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    uint32 iterations = argc > 1 ? uint32(std::strtoul(argv[1], nullptr, 10)) : 200000;
+    if (!iterations)
+        iterations = 1;
+
+    std::vector<Sample> samples = {
+        { "attack", R"({"command": { "type": "attack", "params": { "guid": 2241 } }, "reasoning": "Attacking the nearest enemy that is attacking my group member.", "say": "Engaging the enemy, stay behind me!"})" },
+        { "move_to", R"({"command": {"type": "move_to", "params": {"x": -9347.02, "y": 256.48, "z": 65.1}}, "reasoning": "Heading to the quest giver to the north.", "say": ""})" },
+        { "spell", R"({"command": {"type": "spell", "params": {"spellid": 133, "guid": 2241}}, "reasoning": "Fireball on the target before it reaches me.", "say": "Burn!"})" },
+    };
+
+    uint64 sink = 0;
+    std::printf("%u iterations per sample\n", iterations);
+    for (Sample const& sample : samples)
+    {
+        // Both paths must accept the sample or the numbers compare an error with a decision
+        BotDecision check;
+        LegacyDecision legacyCheck;
+        if (!DecodeBotDecision(sample.reply, check) || !LegacyDecode(sample.reply, legacyCheck, sink))
+        {
+            std::printf("%s: rejected by one of the decoders\n", sample.name);
+            return 1;
+        }
+
+        std::printf("%s\n", sample.name);
+        Measure("nlohmann", sample.reply, iterations, [&sink](std::string const& reply) {
+            LegacyDecision decision;
+            sink += LegacyDecode(reply, decision, sink);
+        });
+        Measure("decoder", sample.reply, iterations, [&sink](std::string const& reply) {
+            BotDecision decision;
+            sink += DecodeBotDecision(reply, decision);
+        });
+    }
+
+    // Keeps the loops from being optimized away
+    return sink == 0 ? 2 : 0;
+}
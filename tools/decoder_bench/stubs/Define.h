@@ -0,0 +1,13 @@
+// Minimal stand-ins for the AzerothCore headers the decoder includes, so the
+// benchmark builds without a server tree. Only what the headers need to parse.
+#pragma once
+#include <cstdint>
+
+typedef int64_t int64;
+typedef int32_t int32;
+typedef int16_t int16;
+typedef int8_t int8;
+typedef uint64_t uint64;
+typedef uint32_t uint32;
+typedef uint16_t uint16;
+typedef uint8_t uint8;
@@ -0,0 +1,14 @@
+#pragma once
+#include "Define.h"
+
+class ObjectGuid
+{
+public:
+    ObjectGuid() = default;
+    explicit ObjectGuid(uint64 guid) : _guid(guid) {}
+    uint64 GetRawValue() const { return _guid; }
+    uint32 GetCounter() const { return uint32(_guid); }
+
+private:
+    uint64 _guid = 0;
+};
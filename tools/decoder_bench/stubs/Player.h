@@ -0,0 +1,5 @@
+#pragma once
+#include "ObjectGuid.h"
+
+class Unit;
+class Player;
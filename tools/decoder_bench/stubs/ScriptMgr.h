@@ -0,0 +1,12 @@
+#pragma once
+#include "Define.h"
+
+class WorldScript
+{
+public:
+    explicit WorldScript(char const* /*name*/) {}
+    virtual ~WorldScript() = default;
+    virtual void OnStartup() {}
+    virtual void OnShutdown() {}
+    virtual void OnUpdate(uint32 /*diff*/) {}
+};